@@ -0,0 +1,118 @@
+/******************************************************************************/
+/*!
+\file		ClientPrediction.cpp
+\author
+\par
+\date
+\brief		This file defines the prediction of the local ship on the client.
+			Inputs run through the server's movement code when they are sent,
+			and are kept until a snapshot shows the server applied them.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "ClientPrediction.h"
+
+#include "ServerSimulation.h"		// SIMULATION_TICK_RATE
+#include "ShipMovement.h"			// MoveShip
+#include "SequenceBuffer.h"			// SequenceBuffer
+#include "TripleBuffer.h"			// TripleBuffer
+
+#include <atomic>					// std::atomic
+#include <mutex>						// std::mutex
+
+static std::mutex predictionMutex;									// inputs come from the main thread, snapshots from the receive thread
+static SequenceBuffer<uint8_t, PREDICTION_BUFFER_SIZE> sentInputs;	// packed input of each tick
+static NetworkTransform predictedShip;
+static TripleBuffer<NetworkTransform> drawnShip;					// predictedShip for the drawing thread, written under predictionMutex
+static uint32_t newestTick;
+static uint32_t reconciledSequence;
+static bool hasReconciled;
+static bool predicting = false;
+static float stepSeconds = 1.0f / SIMULATION_TICK_RATE;			// time the server moves the ship by for each input tick
+static std::atomic<double> inputInterval = 1000.0 / SIMULATION_TICK_RATE;	// stepSeconds in milliseconds, read by the main thread
+
+void ResetPrediction(NetworkTransform const& ship, uint32_t tickRate)
+{
+	std::lock_guard<std::mutex> lock(predictionMutex);
+	stepSeconds = 1.0f / tickRate;
+	inputInterval = 1000.0 / tickRate;
+	sentInputs.Clear();
+	predictedShip = ship;
+	drawnShip.GetWriteBuffer() = predictedShip;
+	drawnShip.Publish();
+	newestTick = 0;
+	hasReconciled = false;
+	predicting = true;
+}
+
+double GetInputInterval()
+{
+	return inputInterval;
+}
+
+void PredictLocalShip(PlayerData& player, uint32_t tick, PlayerInput const& input)
+{
+	std::lock_guard<std::mutex> lock(predictionMutex);
+	if (!predicting || player.stats.lives == 0)
+		return;
+
+	sentInputs.Insert(tick) = input.Pack();
+	newestTick = tick;
+
+	MoveShip(predictedShip, input, stepSeconds);
+	player.transform = predictedShip;
+	drawnShip.GetWriteBuffer() = predictedShip;
+	drawnShip.Publish();
+}
+
+void ReconcileLocalShip(PlayerData& player, NetworkTransform const& authoritative, uint32_t inputTick, uint32_t sequenceNumber)
+{
+	std::lock_guard<std::mutex> lock(predictionMutex);
+	if (!predicting || (hasReconciled && static_cast<int32_t>(sequenceNumber - reconciledSequence) <= 0))
+		return;
+	reconciledSequence = sequenceNumber;
+	hasReconciled = true;
+
+	// Where the ship would be now if the prediction had started from the server's state. An input
+	// no longer kept repeats the one before it
+	NetworkTransform corrected = authoritative;
+	PlayerInput input;
+	if (static_cast<int32_t>(newestTick - inputTick) > PREDICTION_BUFFER_SIZE)
+		inputTick = newestTick - PREDICTION_BUFFER_SIZE;
+	for (uint32_t tick = inputTick + 1; static_cast<int32_t>(newestTick - tick) >= 0; ++tick)
+	{
+		if (uint8_t const* bits = sentInputs.Find(tick))
+		{
+			input.Unpack(*bits);
+		}
+		MoveShip(corrected, input, stepSeconds);
+	}
+
+	// Small errors are blended in over a few snapshots so the ship does not jump
+	float dx = corrected.position.x - predictedShip.position.x;
+	float dy = corrected.position.y - predictedShip.position.y;
+	if (dx * dx + dy * dy > PREDICTION_SNAP_DISTANCE * PREDICTION_SNAP_DISTANCE)
+	{
+		predictedShip = corrected;
+	}
+	else
+	{
+		ApplySmoothCorrection(predictedShip.position, corrected.position, PREDICTION_SMOOTHING, PREDICTION_MAX_CORRECTION);
+		predictedShip.velocity = corrected.velocity;
+		predictedShip.rotation = corrected.rotation;
+	}
+	player.transform = predictedShip;
+	drawnShip.GetWriteBuffer() = predictedShip;
+	drawnShip.Publish();
+}
+
+NetworkTransform const& GetPredictedShip()
+{
+	drawnShip.Update();
+	return drawnShip.GetReadBuffer();
+}
@@ -0,0 +1,45 @@
+/******************************************************************************/
+/*!
+\file		ClientPrediction.h
+\author
+\par
+\date
+\brief		This file declares the prediction of the local ship on the client.
+			The ship moves as soon as a key is pressed, and is corrected with
+			the server's state once its inputs come back in a snapshot.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CLIENT_PREDICTION
+#define CLIENT_PREDICTION // header guard
+
+#include "GameData.h"				// PlayerData, PlayerInput, NetworkTransform
+
+#define PREDICTION_BUFFER_SIZE		64			// input ticks kept until the server applied them, ~1 s
+#define PREDICTION_SNAP_DISTANCE	64.0f		// larger errors are corrected at once, eg. after a respawn
+#define PREDICTION_SMOOTHING		0.3f		// share of the error corrected by each snapshot
+#define PREDICTION_MAX_CORRECTION	4.0f		// largest position change of one correction
+
+// Function to start predicting from the ship the server placed the player at. Each input tick moves
+// the ship by one step of the server's simulation, which runs tickRate steps per second
+void ResetPrediction(NetworkTransform const& ship, uint32_t tickRate);
+
+// Function to get the time between two input ticks in milliseconds, one step of the server's simulation
+double GetInputInterval();
+
+// Function to move the local ship with the input of a new tick, without waiting for the server
+void PredictLocalShip(PlayerData& player, uint32_t tick, PlayerInput const& input);
+
+// Function to correct the local ship with the server's, replaying the inputs the server had not
+// applied yet. Each snapshot is only used once
+void ReconcileLocalShip(PlayerData& player, NetworkTransform const& authoritative, uint32_t inputTick, uint32_t sequenceNumber);
+
+// Function to get the newest predicted ship without waiting for the other threads. Called by the
+// drawing thread only
+NetworkTransform const& GetPredictedShip();
+
+#endif
@@ -15,6 +15,14 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 
 #include "Collision.h" // main headers
 
+#include <algorithm> // std::max, std::min
+
+// SSE is part of every x64 target, and of x86 ones built for it
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define COLLISION_SSE
+#include <xmmintrin.h> // __m128
+#endif
+
 /**************************************************************************/
 /*!
 \brief
@@ -35,6 +43,9 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 \param[out] firstTimeOfCollision (float &)
 	First time of collision
 
+\param[in] dt (float)
+	Time step the rects move over, the collision must happen within it
+
 \return bool
 	Return if true if there is an intersection, and false if there is not
 */
@@ -43,7 +54,8 @@ bool CollisionIntersection_RectRect(const AABB & aabb1,          //Input
 									const AEVec2 & vel1,         //Input 
 									const AABB & aabb2,          //Input 
 									const AEVec2 & vel2,         //Input
-									float& firstTimeOfCollision) //Output: the calculated value of tFirst, below, must be returned here
+									float& firstTimeOfCollision, //Output: the calculated value of tFirst, below, must be returned here
+									float dt)                    //Input
 {
 	/*
 	Implement the collision intersection over here.
@@ -83,10 +95,9 @@ bool CollisionIntersection_RectRect(const AABB & aabb1,          //Input
 	else
 	{
 		f32 tFirst = 0;
-		f32 tLast = (f32)AEFrameRateControllerGetFrameTime();
+		f32 tLast = dt;
 
-		AEVec2 vb;
-		AEVec2Set(&vb, vel2.x - vel1.x, vel2.y - vel1.y);
+		AEVec2 vb{ vel2.x - vel1.x, vel2.y - vel1.y };
 
 		// check via x
 		if (vb.x < 0)
@@ -98,13 +109,13 @@ bool CollisionIntersection_RectRect(const AABB & aabb1,          //Input
 			if (aabb1.max.x < aabb2.min.x)
 			{
 				f32 dFirst = aabb1.max.x - aabb2.min.x;
-				tFirst = max(dFirst / vb.x, tFirst);
+				tFirst = (std::max)(dFirst / vb.x, tFirst);
 			}
 
 			if (aabb1.min.x < aabb2.max.x)
 			{
 				f32 dLast = aabb1.min.x - aabb2.max.x;
-				tLast = min(dLast / vb.x, tLast);
+				tLast = (std::min)(dLast / vb.x, tLast);
 			}
 		}
 		else if (vb.x > 0)
@@ -116,13 +127,13 @@ bool CollisionIntersection_RectRect(const AABB & aabb1,          //Input
 			if (aabb1.min.x > aabb2.max.x)
 			{
 				f32 dFirst = aabb1.min.x - aabb2.max.x;
-				tFirst = max(dFirst / vb.x, tFirst);
+				tFirst = (std::max)(dFirst / vb.x, tFirst);
 			}
 
 			if (aabb1.max.x > aabb2.min.x)
 			{
 				f32 dLast = aabb1.max.x - aabb2.min.x;
-				tLast = min(dLast / vb.x, tLast);
+				tLast = (std::min)(dLast / vb.x, tLast);
 			}
 		}
 		else
@@ -144,13 +155,13 @@ bool CollisionIntersection_RectRect(const AABB & aabb1,          //Input
 			if (aabb1.max.y < aabb2.min.y)
 			{
 				f32 dFirst = aabb1.max.y - aabb2.min.y;
-				tFirst = max(dFirst / vb.y, tFirst);
+				tFirst = (std::max)(dFirst / vb.y, tFirst);
 			}
 
 			if (aabb1.min.y < aabb2.max.y)
 			{
 				f32 dLast = aabb1.min.y - aabb2.max.y;
-				tLast = min(dLast / vb.y, tLast);
+				tLast = (std::min)(dLast / vb.y, tLast);
 			}
 		}
 		else if (vb.y > 0)
@@ -162,13 +173,13 @@ bool CollisionIntersection_RectRect(const AABB & aabb1,          //Input
 			if (aabb1.min.y > aabb2.max.y)
 			{
 				f32 dFirst = aabb1.min.y - aabb2.max.y;
-				tFirst = max(dFirst / vb.y, tFirst);
+				tFirst = (std::max)(dFirst / vb.y, tFirst);
 			}
 
 			if (aabb1.max.y > aabb2.min.y)
 			{
 				f32 dLast = aabb1.max.y - aabb2.min.y;
-				tLast = min(dLast / vb.y, tLast);
+				tLast = (std::min)(dLast / vb.y, tLast);
 			}
 		}
 		else
@@ -185,4 +196,253 @@ bool CollisionIntersection_RectRect(const AABB & aabb1,          //Input
 
 		return true;
 	}
+}
+
+/**************************************************************************/
+/*!
+\brief
+	Empties the batch, keeping its memory for the next one
+
+\return void
+*/
+/**************************************************************************/
+void AABBBatch::Clear()
+{
+	minX.clear();
+	minY.clear();
+	maxX.clear();
+	maxY.clear();
+	velX.clear();
+	velY.clear();
+}
+
+/**************************************************************************/
+/*!
+\brief
+	Adds a moving rect at the end of the batch
+
+\param[in] aabb (const AABB &)
+	Axis-aligned bounding box reference
+
+\param[in] vel (const AEVec2 &)
+	Velocity vector
+
+\return void
+*/
+/**************************************************************************/
+void AABBBatch::Add(const AABB& aabb, const AEVec2& vel)
+{
+	minX.push_back(aabb.min.x);
+	minY.push_back(aabb.min.y);
+	maxX.push_back(aabb.max.x);
+	maxY.push_back(aabb.max.y);
+	velX.push_back(vel.x);
+	velY.push_back(vel.y);
+}
+
+/**************************************************************************/
+/*!
+\brief
+	Gets the number of rects in the batch
+
+\return size_t
+	Number of rects added since the last Clear
+*/
+/**************************************************************************/
+size_t AABBBatch::Size() const
+{
+	return minX.size();
+}
+
+#ifdef COLLISION_SSE
+/**************************************************************************/
+/*!
+\brief
+	Takes a where the mask is set and b elsewhere, in each lane
+
+\return __m128
+	Lanes taken from a and b
+*/
+/**************************************************************************/
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+/**************************************************************************/
+/*!
+\brief
+	Steps 3 and 4 of CollisionIntersection_RectRect on one axis, for four
+	pairs of rects. Every case is computed and the ones that apply are kept,
+	so there is no branch. tFirst only grows and tLast only shrinks, so
+	checking them after both axes gives the same result as after each one
+
+\param[in] min1, max1 (__m128)
+	Extent of the first rects on the axis
+
+\param[in] min2, max2 (__m128)
+	Extent of the second rects on the axis
+
+\param[in] vb (__m128)
+	Velocity of the second rects relative to the first ones on the axis
+
+\param[in,out] tFirst, tLast (__m128 &)
+	Times the rects start and stop overlapping
+
+\param[in,out] miss (__m128 &)
+	Set in the lanes of the rects that cannot intersect
+
+\return void
+*/
+/**************************************************************************/
+static inline void SweepAxis(__m128 min1, __m128 max1, __m128 min2, __m128 max2, __m128 vb,
+							 __m128& tFirst, __m128& tLast, __m128& miss)
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 negative = _mm_cmplt_ps(vb, zero);
+	__m128 positive = _mm_cmpgt_ps(vb, zero);
+
+	__m128 dA = _mm_sub_ps(max1, min2);		// aabb1.max - aabb2.min
+	__m128 dB = _mm_sub_ps(min1, max2);		// aabb1.min - aabb2.max
+
+	// case 1 and case 6 on one side, case 3 and case 6 on the other
+	miss = _mm_or_ps(miss, _mm_andnot_ps(positive, _mm_cmpgt_ps(dB, zero)));
+	miss = _mm_or_ps(miss, _mm_andnot_ps(negative, _mm_cmplt_ps(dA, zero)));
+
+	// the lanes with no velocity divide by 0, but none of their results is kept
+	__m128 tA = _mm_div_ps(dA, vb);
+	__m128 tB = _mm_div_ps(dB, vb);
+
+	// case 4 and case 2
+	__m128 first = Select(_mm_and_ps(negative, _mm_cmplt_ps(dA, zero)), tA,
+						  Select(_mm_and_ps(positive, _mm_cmpgt_ps(dB, zero)), tB, tFirst));
+	tFirst = _mm_max_ps(tFirst, first);
+
+	__m128 last = Select(_mm_and_ps(negative, _mm_cmplt_ps(dB, zero)), tB,
+						 Select(_mm_and_ps(positive, _mm_cmpgt_ps(dA, zero)), tA, tLast));
+	tLast = _mm_min_ps(tLast, last);
+}
+#endif
+
+/**************************************************************************/
+/*!
+\brief
+	Checks the collision between a moving rect and each moving rect of a
+	batch
+
+\param[in] aabb1 (const AABB &)
+	First axis-aligned bounding box reference
+
+\param[in] vel1 (const AEVec2 &)
+	First velocity vector
+
+\param[in] batch (const AABBBatch &)
+	Bounding boxes and velocities tested against the first rect
+
+\param[out] firstTimeOfCollision (float *)
+	Array of batch.Size() values. First time of collision with each rect,
+	0 if they overlap before moving and COLLISION_NONE if they do not
+	intersect
+
+\param[in] dt (float)
+	Time step the rects move over, the collision must happen within it
+
+\return size_t
+	Number of rects of the batch intersecting the first rect
+*/
+/**************************************************************************/
+size_t CollisionIntersection_RectRectBatch(const AABB& aabb1,          //Input
+										   const AEVec2& vel1,         //Input
+										   const AABBBatch& batch,     //Input
+										   float* firstTimeOfCollision, //Output
+										   float dt)                   //Input
+{
+	size_t count = batch.Size();
+	size_t hits = 0;
+	size_t i = 0;
+
+#ifdef COLLISION_SSE
+	__m128 min1X = _mm_set1_ps(aabb1.min.x), min1Y = _mm_set1_ps(aabb1.min.y);
+	__m128 max1X = _mm_set1_ps(aabb1.max.x), max1Y = _mm_set1_ps(aabb1.max.y);
+	__m128 vel1X = _mm_set1_ps(vel1.x), vel1Y = _mm_set1_ps(vel1.y);
+	__m128 none = _mm_set1_ps(COLLISION_NONE);
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 min2X = _mm_loadu_ps(&batch.minX[i]), min2Y = _mm_loadu_ps(&batch.minY[i]);
+		__m128 max2X = _mm_loadu_ps(&batch.maxX[i]), max2Y = _mm_loadu_ps(&batch.maxY[i]);
+
+		// Step 1: overlapping before moving
+		__m128 overlap = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(max1X, min2X), _mm_cmpgt_ps(max1Y, min2Y)),
+									_mm_and_ps(_mm_cmpgt_ps(max2X, min1X), _mm_cmpgt_ps(max2Y, min1Y)));
+
+		// Steps 2 to 4
+		__m128 tFirst = _mm_setzero_ps();
+		__m128 tLast = _mm_set1_ps(dt);
+		__m128 miss = _mm_setzero_ps();
+		SweepAxis(min1X, max1X, min2X, max2X, _mm_sub_ps(_mm_loadu_ps(&batch.velX[i]), vel1X), tFirst, tLast, miss);
+		SweepAxis(min1Y, max1Y, min2Y, max2Y, _mm_sub_ps(_mm_loadu_ps(&batch.velY[i]), vel1Y), tFirst, tLast, miss);
+		miss = _mm_or_ps(miss, _mm_cmpgt_ps(tFirst, tLast));
+
+		// Overlapping rects collide at 0 whatever their velocity
+		__m128 result = _mm_andnot_ps(overlap, Select(miss, none, tFirst));
+		_mm_storeu_ps(&firstTimeOfCollision[i], result);
+
+		int missed = _mm_movemask_ps(_mm_andnot_ps(overlap, miss));
+		hits += 4 - ((missed & 1) + ((missed >> 1) & 1) + ((missed >> 2) & 1) + ((missed >> 3) & 1));
+	}
+#endif
+
+	// What is left of the batch, or all of it without SSE
+	for (; i < count; ++i)
+	{
+		AABB aabb2{ { batch.minX[i], batch.minY[i] }, { batch.maxX[i], batch.maxY[i] } };
+		AEVec2 vel2{ batch.velX[i], batch.velY[i] };
+
+		float tFirst = 0.0f;
+		if (CollisionIntersection_RectRect(aabb1, vel1, aabb2, vel2, tFirst, dt))
+		{
+			firstTimeOfCollision[i] = tFirst;
+			++hits;
+		}
+		else
+		{
+			firstTimeOfCollision[i] = COLLISION_NONE;
+		}
+	}
+	return hits;
+}
+
+/**************************************************************************/
+/*!
+\brief
+	Gets the box covering a moving rect over a time step, from where it
+	starts to where it ends
+
+\param[in] aabb (const AABB &)
+	Axis-aligned bounding box at the start of the step
+
+\param[in] vel (const AEVec2 &)
+	Velocity vector
+
+\param[in] dt (float)
+	Time step the rect moves over
+
+\return AABB
+	Box covering the rect during the whole step
+*/
+/**************************************************************************/
+AABB GetSweptBox(const AABB& aabb, const AEVec2& vel, float dt)
+{
+	AABB swept = aabb;
+	f32 dx = vel.x * dt;
+	f32 dy = vel.y * dt;
+
+	if (dx < 0) swept.min.x += dx;
+	else		swept.max.x += dx;
+
+	if (dy < 0) swept.min.y += dy;
+	else		swept.max.y += dy;
+
+	return swept;
 }
\ No newline at end of file
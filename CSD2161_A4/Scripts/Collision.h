@@ -16,7 +16,12 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 #ifndef CSD1130_COLLISION_H_
 #define CSD1130_COLLISION_H_ // header guard
 
-#include "AEEngine.h" // alpha engine
+#include "AEVec2.h" // AEVec2
+
+#include <vector>	// std::vector
+#include <cstddef>	// size_t
+
+const float			COLLISION_NONE			= -1.0f;		// first time of collision of rects that do not intersect
 
 /**************************************************************************/
 /*!
@@ -34,6 +39,29 @@ struct AABB
 	AEVec2	max;
 };
 
+/**************************************************************************/
+/*!
+\struct AABBBatch
+\brief
+	Axis-aligned bounding boxes with their velocities, stored as one array
+	per component so CollisionIntersection_RectRectBatch tests several of
+	them with each instruction
+*/
+/**************************************************************************/
+struct AABBBatch
+{
+	std::vector<float>	minX;
+	std::vector<float>	minY;
+	std::vector<float>	maxX;
+	std::vector<float>	maxY;
+	std::vector<float>	velX;
+	std::vector<float>	velY;
+
+	void	Clear();
+	void	Add(const AABB& aabb, const AEVec2& vel);
+	size_t	Size() const;
+};
+
 /**************************************************************************/
 /*!
 \brief
@@ -54,6 +82,9 @@ struct AABB
 \param[out] firstTimeOfCollision (float &)
 	First time of collision
 
+\param[in] dt (float)
+	Time step the rects move over, the collision must happen within it
+
 \return bool
 	Return if true if there is an intersection, and false if there is not
 */
@@ -62,7 +93,64 @@ bool CollisionIntersection_RectRect(const AABB& aabb1,            //Input
 									const AEVec2& vel1,           //Input 
 									const AABB& aabb2,            //Input 
 									const AEVec2& vel2,           //Input
-									float& firstTimeOfCollision); //Output: the calculated value of tFirst, must be returned here
+									float& firstTimeOfCollision, //Output: the calculated value of tFirst, must be returned here
+									float dt);                    //Input
+
+/**************************************************************************/
+/*!
+\brief
+	Checks the collision between a moving rect and each moving rect of a
+	batch, giving the same result as CollisionIntersection_RectRect for
+	each of them. Four rects are tested at once where SSE is available
+
+\param[in] aabb1 (const AABB &)
+	First axis-aligned bounding box reference
+
+\param[in] vel1 (const AEVec2 &)
+	First velocity vector
+
+\param[in] batch (const AABBBatch &)
+	Bounding boxes and velocities tested against the first rect
+
+\param[out] firstTimeOfCollision (float *)
+	Array of batch.Size() values. First time of collision with each rect,
+	0 if they overlap before moving and COLLISION_NONE if they do not
+	intersect
+
+\param[in] dt (float)
+	Time step the rects move over, the collision must happen within it
+
+\return size_t
+	Number of rects of the batch intersecting the first rect
+*/
+/**************************************************************************/
+size_t CollisionIntersection_RectRectBatch(const AABB& aabb1,          //Input
+										   const AEVec2& vel1,         //Input
+										   const AABBBatch& batch,     //Input
+										   float* firstTimeOfCollision, //Output
+										   float dt);                  //Input
+
+/**************************************************************************/
+/*!
+\brief
+	Gets the box covering a moving rect over a time step, from where it
+	starts to where it ends. Two rects can only collide during the step if
+	their swept boxes overlap
+
+\param[in] aabb (const AABB &)
+	Axis-aligned bounding box at the start of the step
+
+\param[in] vel (const AEVec2 &)
+	Velocity vector
+
+\param[in] dt (float)
+	Time step the rect moves over
+
+\return AABB
+	Box covering the rect during the whole step
+*/
+/**************************************************************************/
+AABB GetSweptBox(const AABB& aabb, const AEVec2& vel, float dt);
 
 
 #endif // CSD1130_COLLISION_H_
\ No newline at end of file
@@ -0,0 +1,28 @@
+/******************************************************************************/
+/*!
+\file		CollisionBroadphase.cpp
+\author
+\par
+\date
+\brief		This file defines the choice of broadphase.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "CollisionBroadphase.h"
+
+#include "CollisionGrid.h"			// CollisionGrid
+#include "SweepAndPrune.h"			// SweepAndPrune
+
+CollisionBroadphaseType collisionBroadphaseType = CollisionBroadphaseType::GRID;
+
+std::unique_ptr<CollisionBroadphase> CreateCollisionBroadphase(CollisionBroadphaseType type)
+{
+	if (type == CollisionBroadphaseType::SWEEP_AND_PRUNE)
+		return std::make_unique<SweepAndPrune>();
+	return std::make_unique<CollisionGrid>();
+}
@@ -0,0 +1,61 @@
+/******************************************************************************/
+/*!
+\file		CollisionBroadphase.h
+\author
+\par
+\date
+\brief		This file declares the interface of the broadphases, which find
+			the ships and bullets that may hit each asteroid before they are
+			tested with CollisionIntersection_RectRect. The broadphase used
+			is chosen when a game starts.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef COLLISION_BROADPHASE
+#define COLLISION_BROADPHASE // header guard
+
+#include "Collision.h"				// AABB
+
+#include <vector>					// std::vector
+#include <memory>					// std::unique_ptr
+#include <cstdint>					// uint32_t
+
+enum class CollisionBroadphaseType
+{
+	GRID,							// uniform grid filled every step, see CollisionGrid
+	SWEEP_AND_PRUNE					// list of box edges kept sorted from step to step, see SweepAndPrune
+};
+
+// Broadphase of the games started from now on, see collisionBroadphase in the configuration
+extern CollisionBroadphaseType collisionBroadphaseType;
+
+// Every step, the boxes swept by the objects are added after Clear, then FindPairs is called before
+// the candidates of each asteroid are asked for
+class CollisionBroadphase
+{
+public:
+	virtual ~CollisionBroadphase() = default;
+
+	// Starts a step, objects not added again are forgotten
+	virtual void Clear() = 0;
+
+	// Adds the box an object sweeps over the step. The key names the object from step to step,
+	// the index is where the caller keeps it. Asteroids and other objects have their own indices
+	virtual void Add(uint32_t key, uint32_t index, AABB const& box, bool isAsteroid) = 0;
+
+	// Finds the pairs of an asteroid and another object whose boxes may overlap
+	virtual void FindPairs() = 0;
+
+	// Fills found with the index of each object paired with the asteroid of the given index, once
+	// and in increasing order, so they are tested in the order they were stored
+	virtual void GetCandidates(uint32_t asteroid, std::vector<uint32_t>& found) = 0;
+};
+
+// Function to create a broadphase of the given type
+std::unique_ptr<CollisionBroadphase> CreateCollisionBroadphase(CollisionBroadphaseType type);
+
+#endif
@@ -0,0 +1,119 @@
+/******************************************************************************/
+/*!
+\file		CollisionGrid.cpp
+\author
+\par
+\date
+\brief		This file defines the uniform grid used to find which objects
+			may collide before testing them.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "CollisionGrid.h"
+
+#include "GameObjects.h"			// SCREEN_SIZE_X, SCREEN_SIZE_Y
+
+#include <cmath>					// std::floor
+#include <algorithm>				// std::sort, std::fill, std::clamp
+
+// Cell of the coordinate, counted from the edge of the playfield and not wrapped yet
+static float GetCell(float coordinate, float edge)
+{
+	// Clamped so broken positions cannot overflow the conversion to an integer
+	return std::clamp(std::floor((coordinate - edge) / COLLISION_GRID_CELL_SIZE), -1.0e6f, 1.0e6f);
+}
+
+static uint32_t Wrap(int cell, int count)
+{
+	cell %= count;
+	return static_cast<uint32_t>(cell < 0 ? cell + count : cell);
+}
+
+CollisionGrid::CollisionGrid() : _query{ 0 }
+{
+}
+
+void CollisionGrid::Clear()
+{
+	for (std::vector<uint32_t>& cell : _cells)
+	{
+		cell.clear();
+	}
+}
+
+uint32_t CollisionGrid::GetCells(AABB const& box, uint32_t* cells) const
+{
+	float minX = GetCell(box.min.x, -SCREEN_SIZE_X * 0.5f);
+	float minY = GetCell(box.min.y, -SCREEN_SIZE_Y * 0.5f);
+
+	// A box wider than the grid covers every column once
+	int countX = (std::min)(static_cast<int>(GetCell(box.max.x, -SCREEN_SIZE_X * 0.5f) - minX) + 1, COLLISION_GRID_CELLS_X);
+	int countY = (std::min)(static_cast<int>(GetCell(box.max.y, -SCREEN_SIZE_Y * 0.5f) - minY) + 1, COLLISION_GRID_CELLS_Y);
+
+	uint32_t count = 0;
+	for (int y = 0; y < countY; ++y)
+	{
+		uint32_t row = Wrap(static_cast<int>(minY) + y, COLLISION_GRID_CELLS_Y) * COLLISION_GRID_CELLS_X;
+		for (int x = 0; x < countX; ++x)
+		{
+			cells[count++] = row + Wrap(static_cast<int>(minX) + x, COLLISION_GRID_CELLS_X);
+		}
+	}
+	return count;
+}
+
+void CollisionGrid::Add(uint32_t, uint32_t index, AABB const& box, bool isAsteroid)
+{
+	if (isAsteroid)
+	{
+		if (index >= _asteroids.size())
+			_asteroids.resize(index + 1);
+		_asteroids[index] = box;
+		return;
+	}
+
+	uint32_t cells[COLLISION_GRID_CELLS];
+	uint32_t count = GetCells(box, cells);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		_cells[cells[i]].push_back(index);
+	}
+
+	if (index >= _lastQuery.size())
+		_lastQuery.resize(index + 1, 0);
+}
+
+void CollisionGrid::FindPairs()
+{
+}
+
+void CollisionGrid::GetCandidates(uint32_t asteroid, std::vector<uint32_t>& found)
+{
+	found.clear();
+
+	// Starts over before the counter comes back to a query an index may still be marked with
+	if (++_query == 0)
+	{
+		std::fill(_lastQuery.begin(), _lastQuery.end(), 0);
+		_query = 1;
+	}
+
+	uint32_t cells[COLLISION_GRID_CELLS];
+	uint32_t count = GetCells(_asteroids[asteroid], cells);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		for (uint32_t index : _cells[cells[i]])
+		{
+			if (_lastQuery[index] == _query)
+				continue;
+			_lastQuery[index] = _query;
+			found.push_back(index);
+		}
+	}
+	std::sort(found.begin(), found.end());
+}
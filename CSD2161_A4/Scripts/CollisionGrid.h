@@ -0,0 +1,58 @@
+/******************************************************************************/
+/*!
+\file		CollisionGrid.h
+\author
+\par
+\date
+\brief		This file declares the uniform grid used to find which objects
+			may collide before testing them. It covers the playfield and is
+			filled again every step, so only objects sharing a cell are
+			tested against each other.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef COLLISION_GRID
+#define COLLISION_GRID // header guard
+
+#include "CollisionBroadphase.h"	// CollisionBroadphase
+
+#define COLLISION_GRID_CELL_SIZE	64.0f		// larger than an asteroid, so a box covers a few cells at most
+#define COLLISION_GRID_CELLS_X		13			// cells across the 800 pixels of the playfield
+#define COLLISION_GRID_CELLS_Y		10			// cells along the 600 pixels of the playfield
+#define COLLISION_GRID_CELLS		(COLLISION_GRID_CELLS_X * COLLISION_GRID_CELLS_Y)
+
+// Cells wrap around like the playfield, so a box past an edge lands in the cells of the other side
+// instead of being lost. Each cell keeps the indices of the ships and bullets added in it, and the
+// candidates of an asteroid are the ones in the cells its box covers
+class CollisionGrid : public CollisionBroadphase
+{
+public:
+	CollisionGrid();
+
+	// Empties every cell, keeping their memory for the next step
+	void Clear() override;
+
+	// Adds a ship or bullet to every cell its box covers, and keeps the box of an asteroid. The key
+	// is not needed, nothing is kept from the last step
+	void Add(uint32_t key, uint32_t index, AABB const& box, bool isAsteroid) override;
+
+	// Nothing to do, the cells of an asteroid are read when its candidates are asked for
+	void FindPairs() override;
+
+	void GetCandidates(uint32_t asteroid, std::vector<uint32_t>& found) override;
+
+private:
+	// Writes the cells the box covers, returns how many
+	uint32_t GetCells(AABB const& box, uint32_t* cells) const;
+
+	std::vector<uint32_t> _cells[COLLISION_GRID_CELLS];
+	std::vector<AABB> _asteroids;		// asteroid index -> box
+	std::vector<uint32_t> _lastQuery;	// index -> last query that found it, to report it once
+	uint32_t _query;
+};
+
+#endif
@@ -4,7 +4,7 @@
 // Globals
 std::mutex gameDataMutex;
 
-std::unordered_map<uint16_t, PlayerInput> playerInputMap;						// A map containing the player portID against the player input
+std::unordered_map<uint16_t, PlayerInputQueue> playerInputQueueMap;			// A map containing the player portID against the inputs not applied yet
 std::map<uint16_t, PlayerData> playerDataMap;									// Data on server side for all players data
 std::vector<NetworkTransform> asteroids;										// Vector of asteroids
 std::unordered_map<uint16_t, std::vector<NetworkTransform>> playerBulletMap;	// A map containing the player portID against the bullets to track which bullets belong to which player
@@ -4,6 +4,17 @@
 #include <unordered_map>    // unordered map
 #include <map>
 #include "NetworkGameState.h"
+#include "SequenceBuffer.h"
+
+// Bits of a PlayerInput packed into one byte for the network
+enum InputBits : uint8_t
+{
+	INPUT_UP	= 1 << 0,
+	INPUT_DOWN	= 1 << 1,
+	INPUT_RIGHT	= 1 << 2,
+	INPUT_LEFT	= 1 << 3,
+	INPUT_SPACE	= 1 << 4
+};
 
 struct PlayerInput
 {
@@ -16,6 +27,31 @@ struct PlayerInput
 	{
 		upKey = downKey = rightKey = leftKey = spaceKey = false;
 	}
+	uint8_t Pack() const
+	{
+		return static_cast<uint8_t>((upKey ? INPUT_UP : 0) | (downKey ? INPUT_DOWN : 0) | (rightKey ? INPUT_RIGHT : 0) |
+									(leftKey ? INPUT_LEFT : 0) | (spaceKey ? INPUT_SPACE : 0));
+	}
+	void Unpack(uint8_t bits)
+	{
+		upKey = bits & INPUT_UP;
+		downKey = bits & INPUT_DOWN;
+		rightKey = bits & INPUT_RIGHT;
+		leftKey = bits & INPUT_LEFT;
+		spaceKey = bits & INPUT_SPACE;
+	}
+};
+
+#define INPUT_QUEUE_SIZE	64	// ticks of input a client can be ahead of the server simulation
+#define INPUT_MAX_BACKLOG	4	// ticks of input queued before the simulation applies two per step
+
+// Inputs of a client by tick, applied one tick per simulation step
+struct PlayerInputQueue
+{
+	SequenceBuffer<uint8_t, INPUT_QUEUE_SIZE> inputs;	// packed PlayerInput of each tick received
+	uint32_t newestTick = 0;							// newest tick received
+	uint32_t appliedTick = 0;							// newest tick the simulation moved the ship with
+	PlayerInput held;									// input of appliedTick, kept for the ticks lost for good
 };
 
 struct PlayerData
@@ -28,7 +64,7 @@ struct PlayerData
 };
 
 // externs
-extern std::unordered_map<uint16_t, PlayerInput> playerInputMap;
+extern std::unordered_map<uint16_t, PlayerInputQueue> playerInputQueueMap;
 extern std::map<uint16_t, PlayerData> playerDataMap;
 extern std::vector<NetworkTransform> asteroids;
 extern std::unordered_map<uint16_t, std::vector<NetworkTransform>> playerBulletMap;
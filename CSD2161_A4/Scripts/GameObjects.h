@@ -15,6 +15,8 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 #ifndef GAME_OBJECTS
 #define GAME_OBJECTS // header guard
 
+#include <AEExport.h>		// PI
+
 enum class ObjectType
 {
 	OBJ_SHIP,
@@ -22,4 +24,43 @@ enum class ObjectType
 	OBJ_ASTEROID,
 	OBJ_BULLET
 };
+
+// Dimensions shared by the game state and the network encoding
+const float			SHIP_SCALE_X			= 16.0f;		// ship scale x
+const float			SHIP_SCALE_Y			= 16.0f;		// ship scale y
+const float			BULLET_SCALE_X			= 20.0f;		// bullet scale x
+const float			BULLET_SCALE_Y			= 3.0f;			// bullet scale y
+const float			WALL_SCALE_X			= 64.0f;		// wall scale x
+const float			WALL_SCALE_Y			= 164.0f;		// wall scale y
+const float			WALL_POSITION_X			= 300.0f;		// wall position x
+const float			WALL_POSITION_Y			= 150.0f;		// wall position y
+
+const float			SCREEN_SIZE_X			= 800.0f;		// Screen size horizontal for randomiser
+const float			SCREEN_SIZE_Y			= 600.0f;		// Screen size vertical for randomiser
+
+// Gameplay shared by the single player game state and the server simulation
+const float			ASTEROID_MIN_SCALE_X	= 10.0f;		// asteroid minimum scale x
+const float			ASTEROID_MAX_SCALE_X	= 60.0f;		// asteroid maximum scale x
+const float			ASTEROID_MIN_SCALE_Y	= 10.0f;		// asteroid minimum scale y
+const float			ASTEROID_MAX_SCALE_Y	= 60.0f;		// asteroid maximum scale y
+
+const float			SHIP_ACCEL_FORWARD		= 100.0f;		// ship forward acceleration (in m/s^2)
+const float			SHIP_ACCEL_BACKWARD		= 50.0f;		// ship backward acceleration (in m/s^2)
+const float			SHIP_ROT_SPEED			= (2.0f * PI);	// ship rotation speed (degree/second)
+
+const float			BULLET_SPEED			= 400.0f;		// bullet speed (m/s)
+
+const float         BOUNDING_RECT_SIZE      = 1.0f;         // this is the normalized bounding rectangle (width and height) sizes - AABB collision data
+
+const float			ASTEROID_MIN_VEL		= 30.0f;		// asteroid minimum velocity
+
+const float			ASTEROID_MAX_VEL		= 100.0f;		// asteroid maximum velocity
+
+const float			SHIP_MAX_SPEED_FORWARD	= 100.0f;		// ship max speed forward
+
+const float			SHIP_MAX_SPEED_BACKWARD = 50.0f;		// ship max speed backward
+
+const float			SHIP_DECCEL				= 10.0f;		// ship max speed forward
+
+const unsigned long ASTEROID_SCORE			= 100UL;		// score earned from destroying asteroid
 #endif
\ No newline at end of file
@@ -21,6 +21,9 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 #include "NetworkGameState.h"
 #include "GameStateMgr.h"
 #include "Collision.h"
+#include "CollisionBroadphase.h"
+#include "SnapshotInterpolation.h"
+#include "ClientPrediction.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctime>  // for date and time
@@ -40,42 +43,6 @@ const unsigned int	GAME_OBJ_NUM_MAX		= 32;			// The total number of different ob
 const unsigned int	GAME_OBJ_INST_NUM_MAX	= 2048;			// The total number of different game object instances
 
 const unsigned int	SHIP_INITIAL_NUM		= 0;			// initial number of ship lives
-const float			SHIP_SCALE_X			= 16.0f;		// ship scale x
-const float			SHIP_SCALE_Y			= 16.0f;		// ship scale y
-const float			BULLET_SCALE_X			= 20.0f;		// bullet scale x
-const float			BULLET_SCALE_Y			= 3.0f;			// bullet scale y
-const float			ASTEROID_MIN_SCALE_X	= 10.0f;		// asteroid minimum scale x
-const float			ASTEROID_MAX_SCALE_X	= 60.0f;		// asteroid maximum scale x
-const float			ASTEROID_MIN_SCALE_Y	= 10.0f;		// asteroid minimum scale y
-const float			ASTEROID_MAX_SCALE_Y	= 60.0f;		// asteroid maximum scale y
-
-const float			WALL_SCALE_X			= 64.0f;		// wall scale x
-const float			WALL_SCALE_Y			= 164.0f;		// wall scale y
-
-const float			SHIP_ACCEL_FORWARD		= 100.0f;		// ship forward acceleration (in m/s^2)
-const float			SHIP_ACCEL_BACKWARD		= 50.0f;		// ship backward acceleration (in m/s^2)
-const float			SHIP_ROT_SPEED			= (2.0f * PI);	// ship rotation speed (degree/second)
-
-const float			BULLET_SPEED			= 400.0f;		// bullet speed (m/s)
-
-const float         BOUNDING_RECT_SIZE      = 1.0f;         // this is the normalized bounding rectangle (width and height) sizes - AABB collision data
-
-const float			ASTEROID_MIN_VEL		= 30.0f;		// asteroid minimum velocity
-
-const float			ASTEROID_MAX_VEL		= 100.0f;		// asteroid maximum velocity
-
-const float			SCREEN_SIZE_X			= 800.0f;		// Screen size horizontal for randomiser
-
-const float			SCREEN_SIZE_Y			= 600.0f ;		// Screen size vertical for randomiser
-
-const float			SHIP_MAX_SPEED_FORWARD	= 100.0f;		// ship max speed forward
-
-const float			SHIP_MAX_SPEED_BACKWARD = 50.0f;		// ship max speed backward
-
-const float			SHIP_DECCEL				= 10.0f;		// ship max speed forward
-
-const unsigned long ASTEROID_SCORE			= 100UL;		// score earned from destroying asteroid
-
 unsigned long       High_Score              = 0; 
 
 FILE* highscoreFile; 
@@ -97,6 +64,8 @@ enum TYPE
 
 const unsigned long FLAG_ACTIVE				= 0x00000001;
 
+const unsigned long GAME_OBJ_INST_NONE		= ~0ul;			// index of no game object instance
+
 /******************************************************************************/
 /*!
 	Struct/Class Definitions
@@ -112,21 +81,32 @@ struct GameObj
 
 // ---------------------------------------------------------------------------
 
-//Game object instance structure
-struct GameObjInst
+//Handle to a game object instance. The instance moves in the arrays as others are removed, its slot
+//does not. The slot's generation changes when the instance is removed, so old handles can be detected
+struct GameObjInstHandle
+{
+	unsigned long		slot;		// index in the slot arrays
+	unsigned long		generation;	// generation of the slot when the instance was created
+};
+
+//Game object instances, stored as one array per member so each pass only reads the members it uses
+//Instances in use are packed at the front, destroyed ones are removed at the end of the frame
+struct GameObjInstList
 {
-	GameObj *			pObject;	// pointer to the 'original' shape
-	unsigned long		flag;		// bit flag or-ed together
-	AEVec2				scale;		// scaling value of the object instance
-	AEVec2				posCurr;	// object current position
-
-	AEVec2				posPrev;	// object previous position -> it's the position calculated in the previous loop
-
-	AEVec2				velCurr;	// object current velocity
-	float				dirCurr;	// object current direction
-	AABB				boundingBox;// object bouding box that encapsulates the object
-	AEMtx33				transform;	// object transformation matrix: Each frame, 
-									// calculate the object instance's transformation matrix and save it here
+	unsigned long		slot[GAME_OBJ_INST_NUM_MAX];		// slot of the instance's handle
+	unsigned long		type[GAME_OBJ_INST_NUM_MAX];		// object type, the 'original' shape in sGameObjList
+	unsigned long		flag[GAME_OBJ_INST_NUM_MAX];		// bit flag or-ed together
+	AEVec2				scale[GAME_OBJ_INST_NUM_MAX];		// scaling value of the object instance
+	AEVec2				posCurr[GAME_OBJ_INST_NUM_MAX];		// object current position
+
+	AEVec2				posPrev[GAME_OBJ_INST_NUM_MAX];		// object previous position -> it's the position calculated in the previous loop
+
+	AEVec2				velCurr[GAME_OBJ_INST_NUM_MAX];		// object current velocity
+	float				dirCurr[GAME_OBJ_INST_NUM_MAX];		// object current direction
+	AABB				boundingBox[GAME_OBJ_INST_NUM_MAX];	// object bouding box that encapsulates the object
+	AEMtx33				transform[GAME_OBJ_INST_NUM_MAX];	// object transformation matrix: Each frame, 
+															// calculate the object instance's transformation matrix and save it here
+	unsigned long		count;								// number of instances at the front, destroyed ones included until removed
 };
 
 
@@ -141,14 +121,31 @@ static GameObj				sGameObjList[GAME_OBJ_NUM_MAX];				// Each element in this arr
 static unsigned long		sGameObjNum;								// The number of defined game objects
 
 // list of object instances
-static GameObjInst			sGameObjInstList[GAME_OBJ_INST_NUM_MAX];	// Each element in this array represents a unique game object instance (sprite)
-static unsigned long		sGameObjInstNum;							// The number of used game object instances
+static GameObjInstList		sGameObjInstList;							// Each index in these arrays represents a unique game object instance (sprite)
+
+// slots of the handles, each one holds the index of its instance or, when unused, the next unused slot
+static unsigned long		sGameObjInstSlotIndex[GAME_OBJ_INST_NUM_MAX];		// Index of the instance, or next unused slot
+static unsigned long		sGameObjInstSlotGeneration[GAME_OBJ_INST_NUM_MAX];	// Incremented each time the slot is freed
+static unsigned long		sGameObjInstFreeSlot;								// First unused slot, GAME_OBJ_INST_NONE if all are used
+
+// slots of the instances destroyed this frame, freed by gameObjInstRemoveDestroyed
+static unsigned long		sGameObjInstDestroyed[GAME_OBJ_INST_NUM_MAX];
+static unsigned long		sGameObjInstDestroyedNum;
+
+// handle of the ship object
+static GameObjInstHandle	sShip;										// Handle of the "Ship" game object instance
+
+// handle of the wall object
+static GameObjInstHandle	sWall;										// Handle of the "Wall" game object instance
 
-// pointer to the ship object
-static GameObjInst *		spShip;										// Pointer to the "Ship" game object instance
+// pairs of asteroids and ships or bullets that may collide this frame, and those found for an asteroid
+static std::unique_ptr<CollisionBroadphase>	sBroadphase;
+static std::vector<uint32_t>				sCollisionCandidates;
 
-// pointer to the wall object
-static GameObjInst *		spWall;										// Pointer to the "Wall" game object instance
+// candidates still active, tested against the asteroid at once, and the first time of collision with each
+static std::vector<unsigned long>			sCollisionTested;
+static AABBBatch							sCollisionBoxes;
+static std::vector<float>					sCollisionTimes;
 
 // number of ship available (lives 0 = game over)
 //static long					sShipLives;									// The number of lives left
@@ -168,11 +165,16 @@ static bool scoreAlreadySubmitted = false;
 // ---------------------------------------------------------------------------
 
 // functions to create/destroy a game object instance
-GameObjInst *		gameObjInstCreate (unsigned long type, AEVec2* scale,
+GameObjInstHandle	gameObjInstCreate (unsigned long type, AEVec2* scale,
 											   AEVec2 * pPos, AEVec2 * pVel, float dir);
-void				gameObjInstDestroy(GameObjInst * pInst);
+void				gameObjInstDestroy(unsigned long inst);
+void				gameObjInstRemoveDestroyed();
+void				gameObjInstClear();
+unsigned long		gameObjInstGetIndex(GameObjInstHandle handle);
 
 void				Helper_Wall_Collision();
+void				Helper_Network_Objects();
+void				Helper_Object_Transforms();
 
 void				gameObjInstCreateRandomAsteroid();
 
@@ -251,13 +253,16 @@ void GameStateAsteroidsLoad(void)
 	// No game objects (shapes) at this point
 	sGameObjNum = 0;
 
-	// zero the game object instance array
-	memset(sGameObjInstList, 0, sizeof(GameObjInst) * GAME_OBJ_INST_NUM_MAX);
-	// No game object instances (sprites) at this point
-	sGameObjInstNum = 0;
+	// No game object instances (sprites) at this point, every slot is unused
+	sGameObjInstList.count = 0;
+	sGameObjInstDestroyedNum = 0;
+	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
+		sGameObjInstSlotIndex[i] = (i + 1 < GAME_OBJ_INST_NUM_MAX) ? i + 1 : GAME_OBJ_INST_NONE;
+	sGameObjInstFreeSlot = 0;
 
-	// The ship object instance hasn't been created yet, so this "spShip" pointer is initialized to 0
-	spShip = nullptr;
+	// The ship object instance hasn't been created yet, so this "sShip" handle is initialized to none
+	sShip = GameObjInstHandle{ GAME_OBJ_INST_NONE, 0 };
+	sWall = GameObjInstHandle{ GAME_OBJ_INST_NONE, 0 };
 
 	// load/create the mesh data (game objects / Shapes)
 	GameObj * pObj;
@@ -350,8 +355,8 @@ void GameStateAsteroidsInit(void)
 	// create the main ship
 	AEVec2 scale;
 	AEVec2Set(&scale, SHIP_SCALE_X, SHIP_SCALE_Y);
-	spShip = gameObjInstCreate(TYPE_SHIP, &scale, nullptr, nullptr, 0.0f);
-	AE_ASSERT(spShip);
+	sShip = gameObjInstCreate(TYPE_SHIP, &scale, nullptr, nullptr, 0.0f);
+	AE_ASSERT(sShip.slot != GAME_OBJ_INST_NONE);
 	
 	// create the initial 4 asteroids instances using the "gameObjInstCreate" function
 	AEVec2 pos, vel;
@@ -383,9 +388,12 @@ void GameStateAsteroidsInit(void)
 	// create the static wall
 	AEVec2Set(&scale, WALL_SCALE_X, WALL_SCALE_Y);
 	AEVec2 position;
-	AEVec2Set(&position, 300.0f, 150.0f);
-	spWall = gameObjInstCreate(TYPE_WALL, &scale, &position, nullptr, 0.0f);
-	AE_ASSERT(spWall);
+	AEVec2Set(&position, WALL_POSITION_X, WALL_POSITION_Y);
+	sWall = gameObjInstCreate(TYPE_WALL, &scale, &position, nullptr, 0.0f);
+	AE_ASSERT(sWall.slot != GAME_OBJ_INST_NONE);
+
+	// the broadphase can change between games
+	sBroadphase = CreateCollisionBroadphase(collisionBroadphaseType);
 
 	// reset the score and the number of ships
 	sScore      = 0;
@@ -403,6 +411,9 @@ void GameStateAsteroidsUpdate(void)
 {
 
     if (gameType == GameType::MULTIPLAYER) {
+        // the server runs the game, only show its state
+        Helper_Network_Objects();
+        Helper_Object_Transforms();
         return;
     }
 
@@ -433,14 +444,22 @@ void GameStateAsteroidsUpdate(void)
     // v1 = a*t + v0		//This is done when the UP or DOWN key is pressed 
     // Pos1 = v1*t + Pos0
 
+    // the ship keeps its index until the instances destroyed this frame are removed
+    unsigned long ship = gameObjInstGetIndex(sShip);
+    AE_ASSERT(ship != GAME_OBJ_INST_NONE);
+
+    AEVec2& shipVel = sGameObjInstList.velCurr[ship];
+    f32& shipDir = sGameObjInstList.dirCurr[ship];
+    AEVec2 const& shipPos = sGameObjInstList.posCurr[ship];
+
     if (AEInputCheckCurr(AEVK_UP))
     {
         AEVec2 added;
-        AEVec2Set(&added, cosf(spShip->dirCurr), sinf(spShip->dirCurr));
-        spShip->velCurr.x = SHIP_ACCEL_FORWARD * (f32)AEFrameRateControllerGetFrameTime() * added.x + spShip->velCurr.x;
-        spShip->velCurr.y = SHIP_ACCEL_FORWARD * (f32)AEFrameRateControllerGetFrameTime() * added.y + spShip->velCurr.y;
+        AEVec2Set(&added, cosf(shipDir), sinf(shipDir));
+        shipVel.x = SHIP_ACCEL_FORWARD * (f32)AEFrameRateControllerGetFrameTime() * added.x + shipVel.x;
+        shipVel.y = SHIP_ACCEL_FORWARD * (f32)AEFrameRateControllerGetFrameTime() * added.y + shipVel.y;
 
-        float speed = AEVec2Length(&spShip->velCurr); // current "speed" in this frame
+        float speed = AEVec2Length(&shipVel); // current "speed" in this frame
 
         if (speed > 0.0f) // only decelerate if speed is more than 0
         {
@@ -452,18 +471,18 @@ void GameStateAsteroidsUpdate(void)
             speed = min(speed, SHIP_MAX_SPEED_FORWARD); // ensure speed does not go above the maximum
 
             // Normalize and update the velocity
-            AEVec2Scale(&spShip->velCurr, &spShip->velCurr, speed / AEVec2Length(&spShip->velCurr));
+            AEVec2Scale(&shipVel, &shipVel, speed / AEVec2Length(&shipVel));
         }
     }
 
     if (AEInputCheckCurr(AEVK_DOWN))
     {
         AEVec2 added;
-        AEVec2Set(&added, -cosf(spShip->dirCurr), -sinf(spShip->dirCurr));
-        spShip->velCurr.x = SHIP_ACCEL_BACKWARD * (f32)AEFrameRateControllerGetFrameTime() * added.x + spShip->velCurr.x;
-        spShip->velCurr.y = SHIP_ACCEL_BACKWARD * (f32)AEFrameRateControllerGetFrameTime() * added.y + spShip->velCurr.y;
+        AEVec2Set(&added, -cosf(shipDir), -sinf(shipDir));
+        shipVel.x = SHIP_ACCEL_BACKWARD * (f32)AEFrameRateControllerGetFrameTime() * added.x + shipVel.x;
+        shipVel.y = SHIP_ACCEL_BACKWARD * (f32)AEFrameRateControllerGetFrameTime() * added.y + shipVel.y;
 
-        float speed = AEVec2Length(&spShip->velCurr); // current "speed" in this frame
+        float speed = AEVec2Length(&shipVel); // current "speed" in this frame
 
         if (speed > 0.0f) // only decelerate if speed is more than 0
         {
@@ -475,32 +494,32 @@ void GameStateAsteroidsUpdate(void)
             speed = min(speed, SHIP_MAX_SPEED_BACKWARD); // ensure speed does not go above the maximum
 
             // Normalize and update the velocity
-            AEVec2Scale(&spShip->velCurr, &spShip->velCurr, speed / AEVec2Length(&spShip->velCurr));
+            AEVec2Scale(&shipVel, &shipVel, speed / AEVec2Length(&shipVel));
         }
     }
 
     if (AEInputCheckCurr(AEVK_LEFT))
     {
-        spShip->dirCurr += SHIP_ROT_SPEED * (float)(AEFrameRateControllerGetFrameTime());
-        spShip->dirCurr = AEWrap(spShip->dirCurr, -PI, PI);
+        shipDir += SHIP_ROT_SPEED * (float)(AEFrameRateControllerGetFrameTime());
+        shipDir = AEWrap(shipDir, -PI, PI);
     }
 
     if (AEInputCheckCurr(AEVK_RIGHT))
     {
-        spShip->dirCurr -= SHIP_ROT_SPEED * (float)(AEFrameRateControllerGetFrameTime());
-        spShip->dirCurr = AEWrap(spShip->dirCurr, -PI, PI);
+        shipDir -= SHIP_ROT_SPEED * (float)(AEFrameRateControllerGetFrameTime());
+        shipDir = AEWrap(shipDir, -PI, PI);
     }
 
     // Shoot a bullet if space is triggered (Create a new object instance)
     if (AEInputCheckTriggered(AEVK_SPACE))
     {
         // Get the bullet's direction according to the ship's direction
-        f32 dir = spShip->dirCurr;
-        AEVec2 pos = spShip->posCurr;
+        f32 dir = shipDir;
+        AEVec2 pos = shipPos;
 
         // Set the velocity
         AEVec2 vel;
-        AEVec2Set(&vel, cosf(spShip->dirCurr), sinf(spShip->dirCurr));
+        AEVec2Set(&vel, cosf(shipDir), sinf(shipDir));
         AEVec2Scale(&vel, &vel, BULLET_SPEED);
 
         // Create an instance, based on BULLET_SCALE_X and BULLET_SCALE_Y
@@ -514,16 +533,9 @@ void GameStateAsteroidsUpdate(void)
     //  -- For all instances
     // [DO NOT UPDATE THIS PARAGRAPH'S CODE]
     // ======================================================================
-    for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
+    for (unsigned long i = 0; i < sGameObjInstList.count; i++)
     {
-        GameObjInst* pInst = sGameObjInstList + i;
-
-        // skip non-active object
-        if ((pInst->flag & FLAG_ACTIVE) == 0)
-            continue;
-
-        pInst->posPrev.x = pInst->posCurr.x;
-        pInst->posPrev.y = pInst->posCurr.y;
+        sGameObjInstList.posPrev[i] = sGameObjInstList.posCurr[i];
     }
 
     // ======================================================================
@@ -535,17 +547,21 @@ void GameStateAsteroidsUpdate(void)
     //	-- New position of the active instance is updated here with the velocity calculated earlier
     // ======================================================================
 
-    for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
+    f32 dt = (f32)AEFrameRateControllerGetFrameTime();
+    for (unsigned long i = 0; i < sGameObjInstList.count; i++)
     {
-        GameObjInst* pInst = sGameObjInstList + i;
-
-        pInst->posCurr.x += pInst->velCurr.x * (f32)AEFrameRateControllerGetFrameTime();
-        pInst->posCurr.y += pInst->velCurr.y * (f32)AEFrameRateControllerGetFrameTime();
-
-        pInst->boundingBox.min.x = -(BOUNDING_RECT_SIZE / 2.0f) * pInst->scale.x + pInst->posPrev.x;
-        pInst->boundingBox.max.x = (BOUNDING_RECT_SIZE / 2.0f) * pInst->scale.x + pInst->posPrev.x;
-        pInst->boundingBox.min.y = -(BOUNDING_RECT_SIZE / 2.0f) * pInst->scale.y + pInst->posPrev.y;
-        pInst->boundingBox.max.y = (BOUNDING_RECT_SIZE / 2.0f) * pInst->scale.y + pInst->posPrev.y;
+        AEVec2& posCurr = sGameObjInstList.posCurr[i];
+        AEVec2 const& posPrev = sGameObjInstList.posPrev[i];
+        AEVec2 const& scale = sGameObjInstList.scale[i];
+        AABB& boundingBox = sGameObjInstList.boundingBox[i];
+
+        posCurr.x += sGameObjInstList.velCurr[i].x * dt;
+        posCurr.y += sGameObjInstList.velCurr[i].y * dt;
+
+        boundingBox.min.x = -(BOUNDING_RECT_SIZE / 2.0f) * scale.x + posPrev.x;
+        boundingBox.max.x = (BOUNDING_RECT_SIZE / 2.0f) * scale.x + posPrev.x;
+        boundingBox.min.y = -(BOUNDING_RECT_SIZE / 2.0f) * scale.y + posPrev.y;
+        boundingBox.max.y = (BOUNDING_RECT_SIZE / 2.0f) * scale.y + posPrev.y;
     }
 
     // ======================================================================
@@ -579,71 +595,94 @@ void GameStateAsteroidsUpdate(void)
                     Update "Object instances array"
     */
 
-    for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
+    // asteroids spawned by a collision are only tested from the next frame
+    unsigned long instCount = sGameObjInstList.count;
+
+    // only the instances the broadphase pairs with an asteroid's path are tested against it,
+    // the slot of an instance names it from frame to frame
+    sBroadphase->Clear();
+    for (unsigned long j = 0; j < instCount; j++)
+    {
+        unsigned long type = sGameObjInstList.type[j];
+        if (sGameObjInstList.flag[j] && (type == TYPE_ASTEROID || type == TYPE_SHIP || type == TYPE_BULLET))
+        {
+            sBroadphase->Add(sGameObjInstList.slot[j], j,
+                GetSweptBox(sGameObjInstList.boundingBox[j], sGameObjInstList.velCurr[j], dt), type == TYPE_ASTEROID);
+        }
+    }
+    sBroadphase->FindPairs();
+
+    for (unsigned long i = 0; i < instCount; i++)
     {
-        GameObjInst* pInst = sGameObjInstList + i;
+        if (!sGameObjInstList.flag[i] || sGameObjInstList.type[i] != TYPE_ASTEROID)
+        {
+            continue;
+        }
 
-        if (!pInst->flag)
+        sBroadphase->GetCandidates(i, sCollisionCandidates);
+        if (sCollisionCandidates.empty())
         {
             continue;
         }
 
-        if (pInst->pObject->type == TYPE_ASTEROID)
+        sCollisionTested.clear();
+        sCollisionBoxes.Clear();
+        for (unsigned long j : sCollisionCandidates)
         {
-            for (unsigned long j = 0; j < GAME_OBJ_INST_NUM_MAX; j++)
+            if (sGameObjInstList.flag[j])
             {
-                GameObjInst* pInst2 = sGameObjInstList + j;
+                sCollisionTested.push_back(j);
+                sCollisionBoxes.Add(sGameObjInstList.boundingBox[j], sGameObjInstList.velCurr[j]);
+            }
+        }
 
-                if (!pInst2->flag)
-                {
-                    continue;
-                }
+        // a hit only changes the asteroid and the instance hit, so the others can be tested beforehand
+        sCollisionTimes.resize(sCollisionBoxes.Size());
+        if (CollisionIntersection_RectRectBatch(sGameObjInstList.boundingBox[i], sGameObjInstList.velCurr[i], sCollisionBoxes, sCollisionTimes.data(), dt) == 0)
+        {
+            continue;
+        }
 
-                if (pInst2->pObject->type == TYPE_ASTEROID)
-                {
-                    continue;
-                }
+        for (size_t k = 0; k < sCollisionTested.size(); k++)
+        {
+            if (sCollisionTimes[k] == COLLISION_NONE)
+            {
+                continue;
+            }
 
-                if (pInst2->pObject->type == TYPE_SHIP)
-                {
-                    float tFirst;
-                    if (CollisionIntersection_RectRect(pInst->boundingBox, pInst->velCurr, pInst2->boundingBox, pInst2->velCurr, tFirst))
-                    {
-                        // destroy asteroid
-                        gameObjInstDestroy(pInst);
+            unsigned long j = sCollisionTested[k];
+            unsigned long type = sGameObjInstList.type[j];
+            if (type == TYPE_SHIP)
+            {
+                // destroy asteroid
+                gameObjInstDestroy(i);
 
-                        // reset ship position
-                        spShip->posCurr = AEVec2{ 0, 0 };
+                // reset ship position
+                sGameObjInstList.posCurr[ship] = AEVec2{ 0, 0 };
 
-                        // reset ship velocity
-                        spShip->velCurr = AEVec2{ 0, 0 };
+                // reset ship velocity
+                sGameObjInstList.velCurr[ship] = AEVec2{ 0, 0 };
 
-                        --sShipLives;
+                --sShipLives;
 
-                        // spawn new asteroid
-                        gameObjInstCreateRandomAsteroid();
-                    }
-                }
-                else if (pInst2->pObject->type == TYPE_BULLET)
+                // spawn new asteroid
+                gameObjInstCreateRandomAsteroid();
+            }
+            else if (type == TYPE_BULLET)
+            {
+                // destroy game object instances
+                gameObjInstDestroy(i);
+                gameObjInstDestroy(j);
+
+                // add to score
+                sScore += ASTEROID_SCORE;
+
+                // 10% chance to spawn 2 new asteroid instead of 1
+                unsigned int number_to_add = (AERandFloat() > 0.1f) ? 1 : 2;
+
+                for (unsigned int x = 0; x < number_to_add; ++x)
                 {
-                    float tFirst;
-                    if (CollisionIntersection_RectRect(pInst->boundingBox, pInst->velCurr, pInst2->boundingBox, pInst2->velCurr, tFirst))
-                    {
-                        // destroy game object instances
-                        gameObjInstDestroy(pInst);
-                        gameObjInstDestroy(pInst2);
-
-                        // add to score
-                        sScore += ASTEROID_SCORE;
-
-                        // 10% chance to spawn 2 new asteroid instead of 1
-                        unsigned int number_to_add = (AERandFloat() > 0.1f) ? 1 : 2;
-
-                        for (unsigned int x = 0; x < number_to_add; ++x)
-                        {
-                            gameObjInstCreateRandomAsteroid();
-                        }
-                    }
+                    gameObjInstCreateRandomAsteroid();
                 }
             }
         }
@@ -661,47 +700,50 @@ void GameStateAsteroidsUpdate(void)
     //			(Homing missiles are not required for the Asteroids project)
     //		-- Update a particle effect (Not required for the Asteroids project)
     // ===================================================================
-    for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
+    f32 winMinX = AEGfxGetWinMinX(), winMaxX = AEGfxGetWinMaxX();
+    f32 winMinY = AEGfxGetWinMinY(), winMaxY = AEGfxGetWinMaxY();
+    for (unsigned long i = 0; i < sGameObjInstList.count; i++)
     {
-        GameObjInst* pInst = sGameObjInstList + i;
-
         // skip non-active object
-        if ((pInst->flag & FLAG_ACTIVE) == 0)
+        if ((sGameObjInstList.flag[i] & FLAG_ACTIVE) == 0)
             continue;
 
+        AEVec2& posCurr = sGameObjInstList.posCurr[i];
+        unsigned long type = sGameObjInstList.type[i];
+
         // check if the object is a ship
-        if (pInst->pObject->type == TYPE_SHIP)
+        if (type == TYPE_SHIP)
         {
             // Wrap the ship from one end of the screen to the other
-            pInst->posCurr.x = AEWrap(pInst->posCurr.x, AEGfxGetWinMinX() - SHIP_SCALE_X,
-                AEGfxGetWinMaxX() + SHIP_SCALE_X);
-            pInst->posCurr.y = AEWrap(pInst->posCurr.y, AEGfxGetWinMinY() - SHIP_SCALE_Y,
-                AEGfxGetWinMaxY() + SHIP_SCALE_Y);
+            posCurr.x = AEWrap(posCurr.x, winMinX - SHIP_SCALE_X, winMaxX + SHIP_SCALE_X);
+            posCurr.y = AEWrap(posCurr.y, winMinY - SHIP_SCALE_Y, winMaxY + SHIP_SCALE_Y);
         }
 
         // Wrap asteroids here
-        if (pInst->pObject->type == TYPE_ASTEROID)
+        if (type == TYPE_ASTEROID)
         {
             // Wrap the asteroid from one end of the screen to the other
-            pInst->posCurr.x = AEWrap(pInst->posCurr.x, AEGfxGetWinMinX() - pInst->scale.x,
-                AEGfxGetWinMaxX() + pInst->scale.x);
-            pInst->posCurr.y = AEWrap(pInst->posCurr.y, AEGfxGetWinMinY() - pInst->scale.y,
-                AEGfxGetWinMaxY() + pInst->scale.y);
+            AEVec2 const& scale = sGameObjInstList.scale[i];
+            posCurr.x = AEWrap(posCurr.x, winMinX - scale.x, winMaxX + scale.x);
+            posCurr.y = AEWrap(posCurr.y, winMinY - scale.y, winMaxY + scale.y);
         }
 
         // Remove bullets that go out of bounds
-        if (pInst->pObject->type == TYPE_BULLET)
+        if (type == TYPE_BULLET)
         {
-            if (pInst->posCurr.x > AEGfxGetWinMaxX() ||
-                pInst->posCurr.x < AEGfxGetWinMinX() ||
-                pInst->posCurr.y > AEGfxGetWinMaxY() ||
-                pInst->posCurr.y < AEGfxGetWinMinY())
+            if (posCurr.x > winMaxX ||
+                posCurr.x < winMinX ||
+                posCurr.y > winMaxY ||
+                posCurr.y < winMinY)
             {
-                gameObjInstDestroy(pInst);
+                gameObjInstDestroy(i);
             }
         }
     }
 
+    // pack the instances left at the front of the arrays
+    gameObjInstRemoveDestroyed();
+
 
 
 
@@ -710,33 +752,7 @@ void GameStateAsteroidsUpdate(void)
     // calculate the matrix for all objects
     // =====================================================================
 
-    for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
-    {
-        GameObjInst* pInst = sGameObjInstList + i;
-        AEMtx33		 trans, rot, scale;
-
-        // skip non-active object
-        if ((pInst->flag & FLAG_ACTIVE) == 0)
-            continue;
-
-        // Compute the scaling matrix
-        AEMtx33Scale(&scale, pInst->scale.x, pInst->scale.y);
-
-        // Compute the rotation matrix 
-        AEMtx33Rot(&rot, pInst->dirCurr);
-
-        // Compute the translation matrix
-        AEMtx33Trans(&trans, pInst->posCurr.x, pInst->posCurr.y);
-
-        // Concatenate the 3 matrix in the correct order in the object instance's "transform" matrix
-        AEMtx33 result;
-        AEMtx33Concat(&result, &rot, &scale);
-        AEMtx33Concat(&result, &trans, &result);
-
-        // assign game object with the concat transform result
-        pInst->transform = result;
-
-    }
+    Helper_Object_Transforms();
 }
 
 /******************************************************************************/
@@ -762,19 +778,17 @@ void GameStateAsteroidsDraw(void)
 
 
 	// draw all object instances in the list
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
+	for (unsigned long i = 0; i < sGameObjInstList.count; i++)
 	{
-		GameObjInst * pInst = sGameObjInstList + i;
-
 		// skip non-active object
-		if ((pInst->flag & FLAG_ACTIVE) == 0)
+		if ((sGameObjInstList.flag[i] & FLAG_ACTIVE) == 0)
 			continue;
 		
 		// Set the current object instance's transform matrix using "AEGfxSetTransform"
-		AEGfxSetTransform(pInst->transform.m);
+		AEGfxSetTransform(sGameObjInstList.transform[i].m);
 
 		// Draw the shape used by the current object instance using "AEGfxMeshDraw"
-		AEGfxMeshDraw(pInst->pObject->pMesh, AE_GFX_MDM_TRIANGLES);
+		AEGfxMeshDraw(sGameObjList[sGameObjInstList.type[i]].pMesh, AE_GFX_MDM_TRIANGLES);
 	}
 
 	//You can replace this condition/variable by your own data.
@@ -845,12 +859,9 @@ void GameStateAsteroidsDraw(void)
 /******************************************************************************/
 void GameStateAsteroidsFree(void)
 {
-	// kill all object instances in the array using "gameObjInstDestroy"
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; ++i)
-	{
-		GameObjInst* pInst = sGameObjInstList + i;
-		gameObjInstDestroy(pInst);
-	}
+	// kill all object instances in the arrays
+	gameObjInstClear();
+	sBroadphase.reset();
 }
 
 /******************************************************************************/
@@ -877,8 +888,8 @@ void GameStateAsteroidsUnload(void)
 /******************************************************************************/
 /*
 \brief
-	Creates a new instance of game object by allocating the data in the array
-	whose flag is 0 (not used)
+	Creates a new instance of game object at the end of the instances in use,
+	with the first unused slot as its handle
 
 \param[in] type (unsigned long)
 	The type of game object
@@ -895,11 +906,12 @@ void GameStateAsteroidsUnload(void)
 \param[in] dir (float)
 	The direction of the game object
 
-\return GameObjInst *
-	Pointer to the game object instance that is allocated
+\return GameObjInstHandle
+	Handle to the game object instance that is allocated, its slot is
+	GAME_OBJ_INST_NONE if every slot is used
 */
 /******************************************************************************/
-GameObjInst * gameObjInstCreate(unsigned long type, 
+GameObjInstHandle gameObjInstCreate(unsigned long type, 
 							   AEVec2 * scale,
 							   AEVec2 * pPos, 
 							   AEVec2 * pVel, 
@@ -910,48 +922,127 @@ GameObjInst * gameObjInstCreate(unsigned long type,
 
 	AE_ASSERT_PARM(type < sGameObjNum);
 	
-	// loop through the object instance list to find a non-used object instance
-	for (unsigned long i = 0; i < GAME_OBJ_INST_NUM_MAX; i++)
+	// cannot find empty slot => return none
+	unsigned long slot = sGameObjInstFreeSlot;
+	if (slot == GAME_OBJ_INST_NONE)
+		return GameObjInstHandle{ GAME_OBJ_INST_NONE, 0 };
+	sGameObjInstFreeSlot = sGameObjInstSlotIndex[slot];
+
+	// the first index after the instances in use holds the new instance
+	unsigned long i = sGameObjInstList.count++;
+	sGameObjInstSlotIndex[slot]		= i;
+	sGameObjInstList.slot[i]		= slot;
+	sGameObjInstList.type[i]		= type;
+	sGameObjInstList.flag[i]		= FLAG_ACTIVE;
+	sGameObjInstList.scale[i]		= *scale;
+	sGameObjInstList.posCurr[i]		= pPos ? *pPos : zero;
+	sGameObjInstList.posPrev[i]		= sGameObjInstList.posCurr[i];
+	sGameObjInstList.velCurr[i]		= pVel ? *pVel : zero;
+	sGameObjInstList.dirCurr[i]		= dir;
+
+	// return the newly created instance
+	return GameObjInstHandle{ slot, sGameObjInstSlotGeneration[slot] };
+}
+
+/******************************************************************************/
+/*!
+\brief
+	Destroys an instance of game object by setting its flag to 0. It keeps
+	its index, and its handle stays valid, until gameObjInstRemoveDestroyed
+
+\param[in] inst (unsigned long)
+	The index of a game object instance
+*/
+/******************************************************************************/
+void gameObjInstDestroy(unsigned long inst)
+{
+	// if instance is destroyed before, just return
+	if (sGameObjInstList.flag[inst] == 0)
+		return;
+
+	// zero out the flag
+	sGameObjInstList.flag[inst] = 0;
+	sGameObjInstDestroyed[sGameObjInstDestroyedNum++] = sGameObjInstList.slot[inst];
+}
+
+/******************************************************************************/
+/*!
+\brief
+	Removes the instances destroyed this frame. The last instance moves into
+	the index of each one removed, and its slot is freed for a new handle
+
+\return void
+*/
+/******************************************************************************/
+void gameObjInstRemoveDestroyed()
+{
+	for (unsigned long d = 0; d < sGameObjInstDestroyedNum; d++)
 	{
-		GameObjInst * pInst = sGameObjInstList + i;
+		unsigned long slot = sGameObjInstDestroyed[d];
+		unsigned long i = sGameObjInstSlotIndex[slot];
+		unsigned long last = --sGameObjInstList.count;
 
-		// check if current instance is not used
-		if (pInst->flag == 0)
+		if (i != last)
 		{
-			// it is not used => use it to create the new instance
-			pInst->pObject	= sGameObjList + type;
-			pInst->flag		= FLAG_ACTIVE;
-			pInst->scale	= *scale;
-			pInst->posCurr	= pPos ? *pPos : zero;
-			pInst->velCurr	= pVel ? *pVel : zero;
-			pInst->dirCurr	= dir;
-			
-			// return the newly created instance
-			return pInst;
+			sGameObjInstList.slot[i]		= sGameObjInstList.slot[last];
+			sGameObjInstList.type[i]		= sGameObjInstList.type[last];
+			sGameObjInstList.flag[i]		= sGameObjInstList.flag[last];
+			sGameObjInstList.scale[i]		= sGameObjInstList.scale[last];
+			sGameObjInstList.posCurr[i]		= sGameObjInstList.posCurr[last];
+			sGameObjInstList.posPrev[i]		= sGameObjInstList.posPrev[last];
+			sGameObjInstList.velCurr[i]		= sGameObjInstList.velCurr[last];
+			sGameObjInstList.dirCurr[i]		= sGameObjInstList.dirCurr[last];
+			sGameObjInstList.boundingBox[i]	= sGameObjInstList.boundingBox[last];
+			sGameObjInstList.transform[i]	= sGameObjInstList.transform[last];
+			sGameObjInstSlotIndex[sGameObjInstList.slot[i]] = i;
 		}
-	}
 
-	// cannot find empty slot => return 0
-	return 0;
+		// older handles to the slot no longer find an instance
+		++sGameObjInstSlotGeneration[slot];
+		sGameObjInstSlotIndex[slot] = sGameObjInstFreeSlot;
+		sGameObjInstFreeSlot = slot;
+	}
+	sGameObjInstDestroyedNum = 0;
 }
 
 /******************************************************************************/
 /*!
 \brief
-	Destroys an instance of game object by setting its flag to 0
+	Removes every instance and frees their slots
 
-\param[in] pInst (GameObjInst *)
-	The pointer to a game object instance
+\return void
 */
 /******************************************************************************/
-void gameObjInstDestroy(GameObjInst * pInst)
+void gameObjInstClear()
 {
-	// if instance is destroyed before, just return
-	if (pInst->flag == 0)
-		return;
+	for (unsigned long i = 0; i < sGameObjInstList.count; i++)
+	{
+		unsigned long slot = sGameObjInstList.slot[i];
+		++sGameObjInstSlotGeneration[slot];
+		sGameObjInstSlotIndex[slot] = sGameObjInstFreeSlot;
+		sGameObjInstFreeSlot = slot;
+	}
+	sGameObjInstList.count = 0;
+	sGameObjInstDestroyedNum = 0;
+}
 
-	// zero out the flag
-	pInst->flag = 0;
+/******************************************************************************/
+/*!
+\brief
+	Finds the instance of a handle
+
+\param[in] handle (GameObjInstHandle)
+	The handle returned when the instance was created
+
+\return unsigned long
+	Index of the instance, GAME_OBJ_INST_NONE if it was removed
+*/
+/******************************************************************************/
+unsigned long gameObjInstGetIndex(GameObjInstHandle handle)
+{
+	if (handle.slot >= GAME_OBJ_INST_NUM_MAX || sGameObjInstSlotGeneration[handle.slot] != handle.generation)
+		return GAME_OBJ_INST_NONE;
+	return sGameObjInstSlotIndex[handle.slot];
 }
 
 /******************************************************************************/
@@ -963,52 +1054,62 @@ void gameObjInstDestroy(GameObjInst * pInst)
 /******************************************************************************/
 void Helper_Wall_Collision()
 {
+	unsigned long ship = gameObjInstGetIndex(sShip);
+	unsigned long wall = gameObjInstGetIndex(sWall);
+	AE_ASSERT(ship != GAME_OBJ_INST_NONE && wall != GAME_OBJ_INST_NONE);
+
+	AEVec2& shipPos = sGameObjInstList.posCurr[ship];
+	AEVec2& shipVel = sGameObjInstList.velCurr[ship];
+	AEVec2 const& shipPrev = sGameObjInstList.posPrev[ship];
+	AABB const& wallBox = sGameObjInstList.boundingBox[wall];
+
 	//calculate the vectors between the previous position of the ship and the boundary of wall
 	AEVec2 vec1;
-	vec1.x = spShip->posPrev.x - spWall->boundingBox.min.x;
-	vec1.y = spShip->posPrev.y - spWall->boundingBox.min.y;
+	vec1.x = shipPrev.x - wallBox.min.x;
+	vec1.y = shipPrev.y - wallBox.min.y;
 	AEVec2 vec2;
 	vec2.x = 0.0f;
 	vec2.y = -1.0f;
 	AEVec2 vec3;
-	vec3.x = spShip->posPrev.x - spWall->boundingBox.max.x;
-	vec3.y = spShip->posPrev.y - spWall->boundingBox.max.y;
+	vec3.x = shipPrev.x - wallBox.max.x;
+	vec3.y = shipPrev.y - wallBox.max.y;
 	AEVec2 vec4;
 	vec4.x = 1.0f;
 	vec4.y = 0.0f;
 	AEVec2 vec5;
-	vec5.x = spShip->posPrev.x - spWall->boundingBox.max.x;
-	vec5.y = spShip->posPrev.y - spWall->boundingBox.max.y;
+	vec5.x = shipPrev.x - wallBox.max.x;
+	vec5.y = shipPrev.y - wallBox.max.y;
 	AEVec2 vec6;
 	vec6.x = 0.0f;
 	vec6.y = 1.0f;
 	AEVec2 vec7;
-	vec7.x = spShip->posPrev.x - spWall->boundingBox.min.x;
-	vec7.y = spShip->posPrev.y - spWall->boundingBox.min.y;
+	vec7.x = shipPrev.x - wallBox.min.x;
+	vec7.y = shipPrev.y - wallBox.min.y;
 	AEVec2 vec8;
 	vec8.x = -1.0f;
 	vec8.y = 0.0f;
 	if (
-		(AEVec2DotProduct(&vec1, &vec2) >= 0.0f) && (AEVec2DotProduct(&spShip->velCurr, &vec2) <= 0.0f) ||
-		(AEVec2DotProduct(&vec3, &vec4) >= 0.0f) && (AEVec2DotProduct(&spShip->velCurr, &vec4) <= 0.0f) ||
-		(AEVec2DotProduct(&vec5, &vec6) >= 0.0f) && (AEVec2DotProduct(&spShip->velCurr, &vec6) <= 0.0f) ||
-		(AEVec2DotProduct(&vec7, &vec8) >= 0.0f) && (AEVec2DotProduct(&spShip->velCurr, &vec8) <= 0.0f)
+		(AEVec2DotProduct(&vec1, &vec2) >= 0.0f) && (AEVec2DotProduct(&shipVel, &vec2) <= 0.0f) ||
+		(AEVec2DotProduct(&vec3, &vec4) >= 0.0f) && (AEVec2DotProduct(&shipVel, &vec4) <= 0.0f) ||
+		(AEVec2DotProduct(&vec5, &vec6) >= 0.0f) && (AEVec2DotProduct(&shipVel, &vec6) <= 0.0f) ||
+		(AEVec2DotProduct(&vec7, &vec8) >= 0.0f) && (AEVec2DotProduct(&shipVel, &vec8) <= 0.0f)
 		)
 	{
 		float firstTimeOfCollision = 0.0f;
-		if (CollisionIntersection_RectRect(spShip->boundingBox,
-			spShip->velCurr,
-			spWall->boundingBox,
-			spWall->velCurr,
-			firstTimeOfCollision))
+		if (CollisionIntersection_RectRect(sGameObjInstList.boundingBox[ship],
+			shipVel,
+			wallBox,
+			sGameObjInstList.velCurr[wall],
+			firstTimeOfCollision,
+			(f32)AEFrameRateControllerGetFrameTime()))
 		{
 			//re-calculating the new position based on the collision's intersection time
-			spShip->posCurr.x = spShip->velCurr.x * (float)firstTimeOfCollision + spShip->posPrev.x;
-			spShip->posCurr.y = spShip->velCurr.y * (float)firstTimeOfCollision + spShip->posPrev.y;
+			shipPos.x = shipVel.x * (float)firstTimeOfCollision + shipPrev.x;
+			shipPos.y = shipVel.y * (float)firstTimeOfCollision + shipPrev.y;
 
 			//reset ship velocity
-			spShip->velCurr.x = 0.0f;
-			spShip->velCurr.y = 0.0f;
+			shipVel.x = 0.0f;
+			shipVel.y = 0.0f;
 		}
 	}
 }
@@ -1069,6 +1170,85 @@ void gameObjInstCreateRandomAsteroid()
 	gameObjInstCreate(TYPE_ASTEROID, &scale, &pos, &vel, 0.0f);
 }
 
+/******************************************************************************/
+/*!
+\brief
+	Replaces the object instances with the objects of the server, drawn a
+	little in the past so lost or late snapshots do not show. The local
+	ship is drawn where the client predicted it instead
+
+\return void
+*/
+/******************************************************************************/
+void Helper_Network_Objects()
+{
+	static NetworkGameState networkState;
+	if (!SampleInterpolation(networkState, GetTimeNow()))
+		return;
+
+	gameObjInstClear();
+
+	for (uint32_t i = 0; i < networkState.objectCount; ++i)
+	{
+		NetworkObject const& object = networkState.objects[i];
+		NetworkTransform transform = object.transform;
+		unsigned long type = TYPE_ASTEROID;
+		switch (object.type)
+		{
+		case ObjectType::OBJ_SHIP:
+			type = TYPE_SHIP;
+			if (object.identifier == clientPort)
+				transform = GetPredictedShip();
+			break;
+		case ObjectType::OBJ_WALL:		type = TYPE_WALL;		break;
+		case ObjectType::OBJ_BULLET:	type = TYPE_BULLET;		break;
+		case ObjectType::OBJ_ASTEROID:	type = TYPE_ASTEROID;	break;
+		}
+
+		// network structs are packed, copied out before taking their address
+		AEVec2 scale = transform.scale, pos = transform.position, vel = transform.velocity;
+		gameObjInstCreate(type, &scale, &pos, &vel, transform.rotation);
+	}
+}
+
+/******************************************************************************/
+/*!
+\brief
+	Calculates the transform matrix of all active object instances
+
+\return void
+*/
+/******************************************************************************/
+void Helper_Object_Transforms()
+{
+	for (unsigned long i = 0; i < sGameObjInstList.count; i++)
+	{
+		AEMtx33		 trans, rot, scale;
+
+		// skip non-active object
+		if ((sGameObjInstList.flag[i] & FLAG_ACTIVE) == 0)
+			continue;
+
+		// Compute the scaling matrix
+		AEMtx33Scale(&scale, sGameObjInstList.scale[i].x, sGameObjInstList.scale[i].y);
+
+		// Compute the rotation matrix 
+		AEMtx33Rot(&rot, sGameObjInstList.dirCurr[i]);
+
+		// Compute the translation matrix
+		AEMtx33Trans(&trans, sGameObjInstList.posCurr[i].x, sGameObjInstList.posCurr[i].y);
+
+		// Concatenate the 3 matrix in the correct order in the object instance's "transform" matrix
+		AEMtx33 result;
+		AEMtx33Concat(&result, &rot, &scale);
+		AEMtx33Concat(&result, &trans, &result);
+
+		// assign game object with the concat transform result
+		sGameObjInstList.transform[i] = result;
+
+	}
+}
+
 /******************************************************************************/
 /*!
 \brief
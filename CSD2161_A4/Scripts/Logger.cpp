@@ -0,0 +1,152 @@
+/******************************************************************************/
+/*!
+\file		Logger.cpp
+\author
+\par
+\date
+\brief		This file defines the queue of log messages and the thread that
+			writes them. Any thread can queue a message: each slot has a
+			sequence number telling whether it is free, written or being
+			written, so writers only race for the tail index.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "Logger.h"
+
+#include <atomic>					// std::atomic
+#include <mutex>					// std::once_flag, std::call_once
+#include <thread>					// std::thread, std::this_thread
+#include <chrono>					// std::chrono::milliseconds
+#include <iostream>					// std::cout, std::cerr
+#include <cstdint>					// uint32_t
+
+static_assert((LOG_QUEUE_SIZE & (LOG_QUEUE_SIZE - 1)) == 0, "LOG_QUEUE_SIZE must be a power of 2");
+
+struct LogSlot
+{
+	std::atomic<uint32_t> sequence;	// position it can be written at, or position + 1 once written
+	int level;
+	size_t length;
+	char text[LOG_MESSAGE_LENGTH];
+};
+
+static LogSlot logSlots[LOG_QUEUE_SIZE];
+static std::atomic<uint32_t> logTail{ 0 };			// next position claimed by a writer
+static uint32_t logHead = 0;						// next position written out, logging thread only
+static std::atomic<uint32_t> droppedMessages{ 0 };	// messages lost to a full queue
+
+static std::once_flag loggerStarted;
+static std::atomic<bool> loggerRunning{ false };
+static std::thread loggerThread;
+
+// Readable as well as writable, so the message is copied out without building a string
+static thread_local std::stringstream logStream;
+
+// Writes out every message queued, returns false if there was none
+static bool DrainLog()
+{
+	bool drained = false;
+	for (;;)
+	{
+		LogSlot& slot = logSlots[logHead & (LOG_QUEUE_SIZE - 1)];
+		if (slot.sequence.load(std::memory_order_acquire) != logHead + 1)
+			break;
+
+		std::ostream& output = slot.level >= LOG_LEVEL_WARNING ? std::cerr : std::cout;
+		output.write(slot.text, slot.length);
+		output.put('\n');
+
+		// Hands the slot back to the writers for the next round of the ring
+		slot.sequence.store(logHead + LOG_QUEUE_SIZE, std::memory_order_release);
+		++logHead;
+		drained = true;
+	}
+
+	uint32_t dropped = droppedMessages.exchange(0, std::memory_order_relaxed);
+	if (dropped > 0)
+	{
+		std::cerr << "[Log] " << dropped << " messages dropped\n";
+	}
+	if (drained)
+	{
+		std::cout.flush();
+	}
+	return drained;
+}
+
+static void RunLogger()
+{
+	while (loggerRunning.load(std::memory_order_acquire))
+	{
+		if (!DrainLog())
+			std::this_thread::sleep_for(std::chrono::milliseconds(LOG_DRAIN_INTERVAL_MS));
+	}
+	DrainLog();
+}
+
+static void StartLogger()
+{
+	for (uint32_t i = 0; i < LOG_QUEUE_SIZE; ++i)
+	{
+		logSlots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	loggerRunning.store(true, std::memory_order_release);
+	loggerThread = std::thread(RunLogger);
+}
+
+// Stops the logging thread when the program exits, after it wrote what was left
+struct LoggerShutdown
+{
+	~LoggerShutdown()
+	{
+		if (loggerRunning.exchange(false, std::memory_order_acq_rel) && loggerThread.joinable())
+			loggerThread.join();
+	}
+};
+static LoggerShutdown loggerShutdown;
+
+std::ostream& BeginLog()
+{
+	logStream.str(std::string());
+	logStream.clear();
+	return logStream;
+}
+
+void EndLog(int level)
+{
+	std::call_once(loggerStarted, StartLogger);
+
+	// Claims the tail slot, unless it still holds a message from the last round of the ring
+	uint32_t position = logTail.load(std::memory_order_relaxed);
+	LogSlot* slot;
+	for (;;)
+	{
+		slot = &logSlots[position & (LOG_QUEUE_SIZE - 1)];
+		int32_t difference = static_cast<int32_t>(slot->sequence.load(std::memory_order_acquire) - position);
+		if (difference == 0)
+		{
+			if (logTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			droppedMessages.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else
+		{
+			position = logTail.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->level = level;
+	slot->length = static_cast<size_t>(logStream.rdbuf()->sgetn(slot->text, LOG_MESSAGE_LENGTH));
+
+	// Publishes the message to the logging thread
+	slot->sequence.store(position + 1, std::memory_order_release);
+}
@@ -0,0 +1,81 @@
+/******************************************************************************/
+/*!
+\file		Logger.h
+\author
+\par
+\date
+\brief		This file declares the logging macros. Messages are queued
+			without locking and written to the console by a background
+			thread, so logging never waits on console output. Messages
+			below LOG_LEVEL are removed when compiling.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef LOGGER
+#define LOGGER // header guard
+
+#include <sstream>					// std::ostream
+
+#define LOG_LEVEL_DEBUG			0			// per packet and per tick tracing
+#define LOG_LEVEL_INFO			1			// connections, game and rate changes
+#define LOG_LEVEL_WARNING		2			// unexpected packets, unresponsive peers
+#define LOG_LEVEL_ERROR			3			// failed socket calls
+#define LOG_LEVEL_NONE			4			// nothing is logged
+
+// Lowest level compiled in. Release builds leave out the tracing, define LOG_LEVEL to change it
+#ifndef LOG_LEVEL
+#ifdef NDEBUG
+#define LOG_LEVEL				LOG_LEVEL_INFO
+#else
+#define LOG_LEVEL				LOG_LEVEL_DEBUG
+#endif
+#endif
+
+#define LOG_QUEUE_SIZE			1024		// messages waiting to be written, a power of 2. More are dropped
+#define LOG_MESSAGE_LENGTH		256			// longer messages are cut
+#define LOG_DRAIN_INTERVAL_MS	10			// sleep of the logging thread when nothing is queued
+
+// Function to get the stream of the calling thread, emptied for a new message
+std::ostream& BeginLog();
+
+// Function to queue the message written to the stream from BeginLog
+void EndLog(int level);
+
+// The message is streamed, eg. LOG_INFO("Player " << portID << " joined")
+#define LOG_WRITE(level, message)					\
+	do												\
+	{												\
+		std::ostream& logStream = BeginLog();		\
+		logStream << message;						\
+		EndLog(level);								\
+	} while (0)
+
+#if LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(message)		LOG_WRITE(LOG_LEVEL_DEBUG, message)
+#else
+#define LOG_DEBUG(message)		((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(message)		LOG_WRITE(LOG_LEVEL_INFO, message)
+#else
+#define LOG_INFO(message)		((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_WARNING
+#define LOG_WARNING(message)	LOG_WRITE(LOG_LEVEL_WARNING, message)
+#else
+#define LOG_WARNING(message)	((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(message)		LOG_WRITE(LOG_LEVEL_ERROR, message)
+#else
+#define LOG_ERROR(message)		((void)0)
+#endif
+
+#endif
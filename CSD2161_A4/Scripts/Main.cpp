@@ -17,6 +17,8 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 #include "Network.h"	// networking for multiplayer
 
 #include "Main.h"		// main headers
+#include "Server.h"		// RunServer
+#include "ClientPrediction.h"	// PredictLocalShip, GetInputInterval
 #include <thread>
 #include <atomic>
 
@@ -71,194 +73,8 @@ int WINAPI WinMain(HINSTANCE instanceH, HINSTANCE prevInstanceH, LPSTR command_l
 
         gameType = GameType::SERVER;
 		
-		sockaddr_in address{};
-		std::map<uint16_t, sockaddr_in> clients;                    // source_port : sockaddr_in mapping
-        std::unordered_map<uint16_t, std::thread> clientThreads;
-
-		int clientsRequired = 2;
-		int clientCount = 0;
-
-		bool gameStarted = false; // Add a flag
-
-        while (!gameStarted)
-        {
-            NetworkPacket packet = ReceivePacket(udpServerSocket, address);
-
-            // need to check that the packet is valid then record the time
-            if (packet.packetID != UINT16_MAX)
-            {
-                uint16_t port = packet.sourcePortNumber;
-                lastHeardTime[port] = GetTimeNow();
-
-                // check the map to ensure client is connected BEFORE!
-                // if they not connected before, mark them connected
-                if (isPlayerConnected.find(port) == isPlayerConnected.end() ||
-                    !isPlayerConnected[port])
-                {
-                    isPlayerConnected[port] = true;
-                    std::cout << "[Server] Player " << port << " is now connected.\n";
-                }
-            }
-
-            if (packet.packetID == REQ_CONNECT) {
-
-                // Sends acknowledgment
-                HandleConnectionRequest(udpServerSocket, address, packet);
-
-            }
-            else if (packet.packetID == REQ_QUIT) {
-
-                std::cout << "Disconnecting client at port number: " << std::to_string(packet.sourcePortNumber) << std::endl;
-                clientThreads.erase(packet.sourcePortNumber);
-                --clientCount;
-                clientCountGlobal = clientCount;
-                BroadcastClientCount(udpServerSocket, clients);
-
-            }
-            else if (packet.packetID == JOIN_REQUEST) {
-
-                uint16_t portID = packet.sourcePortNumber;
-
-                if (clientCount == clientsRequired && clients.count(portID) == false)
-                {
-                    // ignore request, lobby is full
-                    std::cout << "[Server] Ignoring join, server is full\n";
-                    continue;
-                }
-
-                HandleJoinRequest(udpServerSocket, address, packet);
-
-                isPlayerConnected[portID] = true;
-                lastHeardTime[portID] = GetTimeNow();
-                std::cout << "[Server] Client [" << portID << "] has joined.\n";
-
-                // Check if the client is in the map already
-                if (clients.count(packet.sourcePortNumber) == false)
-                {
-                    // Add the client port to IP to map
-                    clients[packet.sourcePortNumber] = address;
-                    ++clientCount;
-
-                    clientCountGlobal = clientCount;
-
-                    BroadcastClientCount(udpServerSocket, clients);
-
-                    // Create the player data and store it with the port number as key
-                    switch (clientCount)
-                    {
-                    case 1:
-                    {
-                        AEVec2 posVec{ 100, 100 };
-                        AEVec2 scaleVec{ 16, 16 };
-
-                        playerDataMap.emplace(packet.sourcePortNumber, PlayerData(posVec, scaleVec));
-                        break;
-                    }
-                    case 2:
-                    {
-                        AEVec2 posVec{ 200, 200 };
-                        AEVec2 scaleVec{ 16, 16 };
-
-                        playerDataMap.emplace(packet.sourcePortNumber, PlayerData(posVec, scaleVec));
-                        break;
-                    }
-                    case 3:
-                    {
-                        AEVec2 posVec{ 300, 300 };
-                        AEVec2 scaleVec{ 16, 16 };
-
-                        playerDataMap.emplace(packet.sourcePortNumber, PlayerData(posVec, scaleVec));
-                        break;
-                    }
-                    case 4:
-                    {
-                        AEVec2 posVec{ 400, 400 };
-                        AEVec2 scaleVec{ 16, 16 };
-
-                        playerDataMap.emplace(packet.sourcePortNumber, PlayerData(posVec, scaleVec));
-                        break;
-                    }
-                    }
-                    std::cout << "Num Players: " << playerDataMap.size() << std::endl;
-                }
-
-                // Can start game when players is max
-                if (clientCount == clientsRequired)
-                {
-                    // Stop accepting new clients
-                    gameStarted = true;
-
-                    for (auto& [p, addr] : clients)
-                    {
-                        if (playerDataMap.count(p)) // Check if key 'p' exists in the map
-                        {
-                            SendGameStateStart(udpServerSocket, addr, playerDataMap[p]);
-                            // Start a thread for each client
-                            clientThreads[p] = std::thread(HandleClientInput, udpServerSocket, p, std::ref(playerDataMap));
-                        }
-                        else
-                        {
-                            std::cerr << "Player " << p << " not found in playersData!" << std::endl;
-                        }
-                    }
-                    // Setting the game state for all objects
-                    gameDataState.playerCount = gameDataState.objectCount = clientCount;
-
-                    // Set the player as the object in the game state
-                    for (auto& [port, data] : playerDataMap)
-                    {
-                        static int i = 0;
-                        gameDataState.objects[i].transform.position = data.transform.position;
-                        gameDataState.objects[i].type = ObjectType::OBJ_SHIP;
-                        gameDataState.objects[i].identifier = port;
-                        ++i;
-                    }
-
-                }
-            } else {
-                if (packet.packetID != UINT16_MAX) {
-                    std::cout << "Received unknown packet from " << packet.sourcePortNumber << std::endl;
-                }
-                
-            }
-        }
-        
-		// Start a thread to broadcast the game state
-		std::thread gameStateThread(BroadcastGameState, udpServerSocket, std::ref(clients));
-		// Run in the background
-		gameStateThread.detach(); 
-
-		// Start a thread to calculate the Game Loop
-		std::thread gameLoopState(GameLoop, std::ref(clients));
-		// Run in the background
-		gameLoopState.detach();
-
-		// After game starts, wait for all threads to finish
-		for (auto& [p, thread] : clientThreads)
-		{
-			if (thread.joinable())
-				thread.join();
-		}
-
-
-		// Collate scores onto the leaderboard
-		LoadLeaderboard();
-
-		// Get current time
-		char timeBuffer[20];
-		std::time_t currentTime = std::time(nullptr);
-		std::tm localTime;
-		localtime_s(&localTime, &currentTime);
-		std::strftime(timeBuffer, 20, "%Y-%m-%d %H:%M:%S", &localTime);
-
-		for (auto [id, score, lives] : gameDataState.playerData)
-		{
-			AddScoreToLeaderboard(id, "", score, timeBuffer);
-		}
-		SaveLeaderboard();
-
-		// End of game, send the final leaderboard to the clients
-		BroadcastLeaderboard(udpServerSocket, std::ref(clients));
+		// Runs the lobby and the game until every client left
+		RunServer();
 
 		// Show leaderboard
         if (sShipLives < 0) {
@@ -290,7 +106,7 @@ int WINAPI WinMain(HINSTANCE instanceH, HINSTANCE prevInstanceH, LPSTR command_l
         receiveThread.detach(); // Detach it to run in background
 
         // Start the background thread for rendering on the client side
-        std::thread renderThread(Render, std::ref(gameDataState));
+        std::thread renderThread(Render);
         renderThread.detach(); // Detach it to run in background
 
         //HWND clientWindow = GetConsoleWindow();
@@ -305,7 +121,7 @@ int WINAPI WinMain(HINSTANCE instanceH, HINSTANCE prevInstanceH, LPSTR command_l
             //    continue;
             //}
 
-            // Player has to send join request in order to have the HandleClientInput actually handle the input packets
+            // Player has to send join request in order to have the HandleClientPackets actually handle the input packets
             // So, while player is in the main menu, let the following code handle the player input instead
             if (gGameStateCurr == GS_MAINMENU) {
                 if (GetAsyncKeyState('L') & 0x8000 ) {
@@ -318,25 +134,30 @@ int WINAPI WinMain(HINSTANCE instanceH, HINSTANCE prevInstanceH, LPSTR command_l
                 }
             } else {
 
-                // Handle input
-                NetworkPacket packet;
-                packet.packetID = InputKey::NONE;
+                // Handle input, every key held is sent
+                PlayerInput input;
+                input.upKey = GetAsyncKeyState(VK_UP) & 0x8000;
+                input.downKey = GetAsyncKeyState(VK_DOWN) & 0x8000;
+                input.leftKey = GetAsyncKeyState(VK_LEFT) & 0x8000;
+                input.rightKey = GetAsyncKeyState(VK_RIGHT) & 0x8000;
+                input.spaceKey = GetAsyncKeyState(VK_SPACE) & 0x8000;
 
-                if (GetAsyncKeyState(VK_UP) & 0x8000)      packet.packetID = InputKey::UP;
-                else if (GetAsyncKeyState(VK_DOWN) & 0x8000) packet.packetID = InputKey::DOWN;
-                else if (GetAsyncKeyState(VK_LEFT) & 0x8000) packet.packetID = InputKey::LEFT;
-                else if (GetAsyncKeyState(VK_RIGHT) & 0x8000) packet.packetID = InputKey::RIGHT;
-                else if (GetAsyncKeyState(VK_SPACE) & 0x8000) packet.packetID = InputKey::SPACE;
-                else if (GetAsyncKeyState('Q') & 0x8000) {
+                if (GetAsyncKeyState('Q') & 0x8000) {
                     SendQuitRequest(udpClientSocket, serverTargetAddress);
                     gGameStateNext = GS_QUIT;
                     break;
                 }
 
-                if (packet.packetID != InputKey::NONE) {
-                    packet.sourcePortNumber = GetClientPort();
-                    packet.destinationPortNumber = serverTargetAddress.sin_port;
-                    SendPacket(udpClientSocket, serverTargetAddress, packet);
+                // One input tick per step of the server while in a game, also when no key is held so
+                // releases arrive. Ticks keep the server's pace on average, after a stall they start again from now
+                static double nextInputTime = 0;
+                uint64_t now = GetTimeNow();
+                if (gGameStateCurr == GS_ASTEROIDS && now >= nextInputTime) {
+                    uint32_t tick = SendInput(udpClientSocket, serverTargetAddress, input);
+                    PredictLocalShip(clientData, tick, input);
+                    nextInputTime += GetInputInterval();
+                    if (nextInputTime < now)
+                        nextInputTime = static_cast<double>(now);
                 }
             }
 
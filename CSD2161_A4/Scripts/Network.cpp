@@ -1,5 +1,12 @@
 #include "Network.h"
-#include "Main.h"		// main headers
+#include "NetworkConnection.h"	// NetworkConnection
+#include "SpscQueue.h"			// SpscQueue
+#include "NetworkBatch.h"		// QueueDatagram, ReceiveDatagram
+#include "ServerSimulation.h"	// simulationTickRate, WriteSimulationState
+#include "CollisionBroadphase.h"	// collisionBroadphaseType
+#include "Logger.h"				// LOG_INFO, LOG_WARNING, LOG_ERROR
+#include <chrono>		// steady_clock
+#include <algorithm>	// std::clamp
 
 // Define
 NetworkType networkType = NetworkType::UNINITIALISED;
@@ -12,33 +19,48 @@ SOCKET udpServerSocket = INVALID_SOCKET;                        // used for Netw
 std::mutex packetMutex;
 std::mutex playerDataMutex;
 
-uint32_t nextSeqNum = SEQ_NUM_MIN;
-uint32_t sendBase = SEQ_NUM_MIN;
-uint32_t recvBase = SEQ_NUM_MIN;
+InputFrames inputHistory{};                                     // used for NetworkType::CLIENT, inputs of the latest ticks
 
-std::map<uint32_t, NetworkPacket> sendBuffer{};                 // Packets awaiting ACK
-std::map<uint32_t, NetworkPacket> recvBuffer{};                 // Stores received packets
-std::set<uint32_t> ackedPackets;                                // Tracks received ACKs
-std::map<uint32_t, uint64_t> timers{};                          // Timeout tracking of un-ACK packets
+// Packets read from the server socket by the event loop, held per client until the next simulation step
+struct ClientInbox
+{
+    sockaddr_in address;
+    SpscQueue<NetworkPacket, CLIENT_QUEUE_SIZE> packets;
+};
+static std::map<uint16_t, std::unique_ptr<ClientInbox>> clientInboxes;  // used for NetworkType::SERVER, only changed before the game starts
+
+std::mutex snapshotMutex;
+std::map<uint16_t, ClientSnapshotState> clientSnapshots;        // used for NetworkType::SERVER, baselines per client port
+SnapshotBuffer receivedSnapshots;                               // used for NetworkType::CLIENT, baselines received from server
+SnapshotAssembly snapshotAssemblies[SNAPSHOT_ASSEMBLY_COUNT];   // used for NetworkType::CLIENT, snapshots being rebuilt from fragments
 
-const std::string configFileRelativePath = "Resources/Configuration.txt";
+const std::string configFileRelativePath = "Resources/configuration.txt";
 const std::string configFileServerIp = "serverIp";
 const std::string configFileServerPort = "serverUdpPort";
+const std::string configFileServerTickRate = "serverTickRate";
+const std::string configFileSnapshotRate = "snapshotRate";
+const std::string configFileCollisionBroadphase = "collisionBroadphase";   // grid or sweepAndPrune
 
 uint32_t clientCountGlobal = 0;
+uint32_t snapshotRate = SNAPSHOT_DEFAULT_RATE;                  // used for NetworkType::SERVER, highest snapshots per second sent to a client
 uint32_t DISCONNECT_THRESHOLD_MS = TIMEOUT_MS_MAX;
 
+// The headless server already runs in a terminal
 void AttachConsoleWindow()
 {
+#ifdef _WIN32
 	AllocConsole();
 	FILE* fp;
 	freopen_s(&fp, "CONOUT$", "w", stdout);
 	freopen_s(&fp, "CONIN$", "r", stdin);
+#endif
 }
 
 void FreeConsoleWindow()
 {
+#ifdef _WIN32
 	FreeConsole();
+#endif
 }
 
 int InitialiseNetwork()
@@ -82,6 +104,33 @@ int StartServer()
                 portString = buffer.substr(findIndex + configFileServerPort.size() + 1);
                 serverPort = static_cast<uint16_t>(std::stoi(portString));
             }
+
+            // Optional, the simulation keeps its default rate without it
+            findIndex = buffer.find(configFileServerTickRate);
+            if (findIndex != std::string::npos) {
+                simulationTickRate = static_cast<uint32_t>(std::stoi(buffer.substr(findIndex + configFileServerTickRate.size() + 1)));
+            }
+
+            findIndex = buffer.find(configFileSnapshotRate);
+            if (findIndex != std::string::npos) {
+                snapshotRate = static_cast<uint32_t>(std::stoi(buffer.substr(findIndex + configFileSnapshotRate.size() + 1)));
+            }
+
+            findIndex = buffer.find(configFileCollisionBroadphase);
+            if (findIndex != std::string::npos) {
+                std::string broadphase = buffer.substr(findIndex + configFileCollisionBroadphase.size() + 1);
+                broadphase.erase(broadphase.find_last_not_of(" \t\r") + 1);
+                if (broadphase == "sweepAndPrune") {
+                    collisionBroadphaseType = CollisionBroadphaseType::SWEEP_AND_PRUNE;
+                }
+                else if (broadphase == "grid") {
+                    collisionBroadphaseType = CollisionBroadphaseType::GRID;
+                }
+                else {
+                    collisionBroadphaseType = CollisionBroadphaseType::GRID;
+                    LOG_WARNING("Unknown collision broadphase " << broadphase << ", using the grid");
+                }
+            }
         }
     }
 
@@ -295,111 +344,89 @@ void Disconnect(SOCKET& socket)
 	WSACleanup();
 }
 
-bool SendPacket(SOCKET socket, sockaddr_in address, NetworkPacket packet, bool is_retransmit)
+// Sends the header and used payload of the packet as is, without touching any window
+bool SendDatagram(SOCKET socket, const sockaddr_in& address, const NetworkPacket& packet)
 {
-    if (is_retransmit) {
-
-        int sentBytes = sendto(socket, (char*)&packet, sizeof(packet), 0, (sockaddr*)&address, sizeof(address));
-
-        if (sentBytes == SOCKET_ERROR) {
-
-            std::cerr << "Failed to send game data. Error: " << WSAGetLastError() << std::endl;
-
-            return false;
-        }
-
-    } else if ((nextSeqNum + 1 % SEQ_NUM_SPACE != (sendBase + WIND_SIZE) % SEQ_NUM_SPACE) || networkType == NetworkType::SERVER) {
-
-        std::cout << std::endl;
-        std::cout << "Sending packet of sequence number: " << nextSeqNum << std::endl;
-        std::cout << "Packet id is " << std::to_string(packet.packetID) << std::endl;
-        std::cout << "Flag is " << std::to_string(packet.flags) << std::endl;
-        std::cout << std::endl;
-
-        packet.seqNumber = nextSeqNum;
+    // Sent later with the rest of the batch if this thread started one
+    if (QueueDatagram(socket, address, packet)) {
+        return true;
+    }
 
-        int sentBytes = sendto(socket, (char*)&packet, sizeof(packet), 0, (sockaddr*)&address, sizeof(address));
+    int sentBytes = sendto(socket, (const char*)&packet, GetPacketSize(packet), 0, (const sockaddr*)&address, sizeof(address));
 
-        if (sentBytes == SOCKET_ERROR) {
+    if (sentBytes == SOCKET_ERROR) {
 
-            std::cerr << "Failed to send game data. Error: " << WSAGetLastError() << std::endl;
+        LOG_ERROR("Failed to send game data. Error: " << WSAGetLastError());
 
-            return false;
+        return false;
+    }
 
-        } else {
+    return true;
+}
 
-            nextSeqNum = (nextSeqNum + 1) % SEQ_NUM_SPACE;
+// Lobby and end of game messages must arrive, game states and inputs are only useful while fresh
+Channel GetPacketChannel(uint16_t packetID)
+{
+    switch (packetID)
+    {
+    case GAME_STATE_UPDATE:
+    case GAME_STATE_ACK:
+        return Channel::UNRELIABLE_SEQUENCED;
 
-            if (networkType != NetworkType::SERVER) {
+    case GAME_INPUT:
+        return Channel::UNRELIABLE;
 
-                if (packet.flags == 0) {
-                    sendBuffer[packet.seqNumber] = packet;
-                    timers[packet.seqNumber] = GetTimeNow();
+    case REQ_QUIT:
+        return Channel::RELIABLE_UNORDERED;
 
-                }
-            }
+    default:
+        return Channel::RELIABLE_ORDERED;
+    }
+}
 
-        }
+bool SendPacket(SOCKET socket, sockaddr_in address, NetworkPacket packet, bool is_retransmit)
+{
+    if (is_retransmit) {
 
+        return SendDatagram(socket, address, packet);
     }
 
-    return true;
-
+    // Each peer has its own window, only the reliable channels are kept for retransmission
+    return GetConnection(address).Send(socket, address, packet, GetPacketChannel(packet.packetID));
 }
 
 NetworkPacket ReceivePacket(SOCKET socket, sockaddr_in& address)
 {
 	NetworkPacket packet;
 
-    int addressSize = sizeof(address);
-    int receivedBytes = recvfrom(socket, (char*)&packet, sizeof(packet), 0, (sockaddr*)&address, &addressSize);
+    // Ordered packets held back by a gap are handed out before reading the socket again
+    if (PopReadyPacket(packet, address)) {
+        return packet;
+    }
+
+    int receivedBytes = ReceiveDatagram(socket, packet, address);
 
 	if (receivedBytes == SOCKET_ERROR)
 	{
         size_t errorCode = WSAGetLastError();
 
-		std::cerr << "Failed to receive data. Error: " << errorCode << std::endl;
+		LOG_ERROR("Failed to receive data. Error: " << errorCode);
 
         packet.packetID = UINT16_MAX;
 
-	} else {
-
-        uint32_t seqNum = packet.seqNumber;
-
-        if ((seqNum >= recvBase && seqNum < recvBase + WIND_SIZE) ||
-            (seqNum < recvBase && (seqNum + SEQ_NUM_SPACE) < (recvBase + WIND_SIZE))) {
-
-            std::cout << "\nReceived a packet!\n";
-            std::cout << "Sequence number: " << seqNum << "\n";
-            std::cout << "Packet ID: " << std::to_string(packet.packetID) << "\n";
-            std::cout << "Flag: " << std::to_string(packet.flags) << "\n\n";
-
-            recvBuffer[seqNum] = packet;
-
-            if (packet.flags == 0) {
-                // Slide window forward when contiguous packets are received
-                while (recvBuffer.count(recvBase)) {
-                    recvBuffer.erase(recvBase);
-                    recvBase = (recvBase + 1) % SEQ_NUM_SPACE;
-                }
-            }
-            else if (packet.flags == 1 && networkType == NetworkType::CLIENT) {
+	} else if (receivedBytes < NETWORK_HEADER_SIZE || packet.payloadLength > DEFAULT_BUFLEN ||
+               receivedBytes != GetPacketSize(packet)) {
 
-                if (sendBuffer.find(packet.seqNumber) != sendBuffer.end()) {
+        // Truncated or malformed datagram
+        LOG_WARNING("Dropped malformed packet of " << receivedBytes << " bytes");
 
-                    ackedPackets.insert(packet.seqNumber);
+        packet.packetID = UINT16_MAX;
 
-                    // Advance sendBase if the lowest unacknowledged packet is now acknowledged
-                    while (ackedPackets.count(sendBase)) {
-                        std::cout << "\nSliding window: removing " << sendBase << std::endl;
-                        sendBuffer.erase(sendBase);
-                        timers.erase(sendBase);
-                        ackedPackets.erase(sendBase);
-                        sendBase = (sendBase + 1) % SEQ_NUM_SPACE;
-                    }
-                }
-            }
+	} else {
 
+        // Duplicates, out of date and held back packets are not handed out
+        if (!GetConnection(address).Receive(socket, address, packet)) {
+            packet.packetID = UINT16_MAX;
         }
     }
 
@@ -408,58 +435,19 @@ NetworkPacket ReceivePacket(SOCKET socket, sockaddr_in& address)
 
 void RetransmitPacket() {
 
-    std::map<uint32_t, uint64_t> accumulative_timers{};
-    for (auto& [seqNum, time] : timers) {
-        accumulative_timers[seqNum] = 0;
-    }
-
-    // Retransmission
-    uint64_t now = GetTimeNow();
-    for (auto& [seqNum, timer] : timers) {
-
-        if (now - timer >= TIMEOUT_MS && accumulative_timers[seqNum] < TIMEOUT_MS_MAX) {
-
-            //std::cout << "Timeout resending packet with sequence number: " << seqNum << std::endl;
-
-            SendPacket(udpClientSocket, serverTargetAddress, sendBuffer[seqNum], true);
-
-            accumulative_timers[seqNum] += (now - timer);
-            timers[seqNum] = now;  // Update retransmission time
-
-        } else if (accumulative_timers[seqNum] >= TIMEOUT_MS_MAX) {
-
-            // Receiver is unresponsive, exit loop
-            std::cout << "Receiver unresponsive. Resetting connection.\n";
-            sendBuffer.clear();
-            timers.clear();
-            ackedPackets.clear();
-            accumulative_timers.clear();
-            nextSeqNum = sendBase;
-            return;
-        }
-    }
+    UpdateConnections(GetTimeNow());
 }
 
+// Acknowledge right away, instead of waiting for outgoing traffic to carry the ACK
 bool SendAck(SOCKET socket, sockaddr_in address, NetworkPacket packet) {
 
-    packet.flags = 1;
-
-    int sentBytes = sendto(socket, (char*)&packet, sizeof(packet), 0, (sockaddr*)&address, sizeof(address));
-
-    if (sentBytes == SOCKET_ERROR) {
-
-        std::cerr << "Failed to send ACK. Error: " << WSAGetLastError() << std::endl;
-
-        return false;
-
-    }
-    return true;
+    return GetConnection(address).SendAck(socket, address, packet);
 }
 
 void HandleConnectionRequest(SOCKET socket, sockaddr_in address, NetworkPacket packet) {
 
     if (packet.packetID == REQ_CONNECT && packet.flags == 0) {
-        std::cout << "Server is acknowledging connnection request" << std::endl;
+        LOG_INFO("Server is acknowledging connnection request");
         SendAck(socket, address, packet);
     }
 }
@@ -474,20 +462,40 @@ void SendQuitRequest(SOCKET socket, sockaddr_in address) {
     SendPacket(socket, address, packet, false);
 }
 
+int GetPacketSize(const NetworkPacket& packet)
+{
+    return NETWORK_HEADER_SIZE + packet.payloadLength;
+}
+
+void SetPacketPayload(NetworkPacket& packet, const void* payload, size_t size)
+{
+    size = (size < DEFAULT_BUFLEN) ? size : DEFAULT_BUFLEN;
+    memcpy(packet.data, payload, size);
+    packet.payloadLength = static_cast<uint16_t>(size);
+}
+
 // Pack the player data into the network packet for sending
 void PackPlayerData(NetworkPacket& packet, const PlayerData& player)
 {
 	std::lock_guard<std::mutex> lock(packetMutex);
-	memset(packet.data, 0, DEFAULT_BUFLEN); // Ensure buffer is cleared
-	memcpy(packet.data, &player, sizeof(PlayerData)); // Copy struct into buffer
+	SetPacketPayload(packet, &player, sizeof(PlayerData)); // Copy struct into buffer
 }
 
-void PackGameStateData(NetworkPacket& packet, const NetworkGameState& gameState)
+// Pack the game state as a delta against the last snapshot the client acknowledged
+// Returns the number of fragments to send, most important objects first
+uint32_t PackGameStateData(SnapshotFragment* fragments, const NetworkGameState& gameState, uint16_t clientPortID, ClientSnapshotState& client)
 {
-	std::lock_guard<std::mutex> lock1(packetMutex);
-	std::lock_guard<std::mutex> lock2(gameDataMutex);
-	memset(packet.data, 0, DEFAULT_BUFLEN); // Ensure buffer is cleared
-	memcpy(packet.data, &gameState, sizeof(NetworkGameState)); // Copy struct into buffer
+	// Kept across calls like the snapshot of BroadcastGameState, the only caller
+	static uint16_t order[MAX_NETWORK_OBJECTS];
+	static NetworkGameState reconstructed;
+	GetSnapshotPriorityOrder(gameState, clientPortID, order);
+
+	const NetworkGameState* baseline = client.sent.Find(client.ackedSequence);
+	uint32_t fragmentCount = WriteSnapshotFragments(gameState, baseline, order, reconstructed, fragments);
+
+	// Keep what the client will reconstruct, so it can be used as a baseline once acknowledged
+	client.sent.Store(reconstructed);
+	return fragmentCount;
 }
 
 
@@ -500,18 +508,68 @@ void UnpackPlayerData(const NetworkPacket& packet, PlayerData& player)
 }
 
 
-// Unpacking the data from the network packet into the player data
-void UnpackGateStateData(const NetworkPacket& packet)
+// Unpacking one snapshot fragment from the network packet into the game state
+// Returns false if the fragment cannot be decoded. complete is set once every fragment of the
+// snapshot has arrived, its sequence number should then be acknowledged
+bool UnpackGateStateData(const NetworkPacket& packet, uint32_t& sequenceNumber, bool& complete)
 {
 	std::lock_guard<std::mutex> lock1(packetMutex);
+
+	SnapshotAssembly* assembly = ReadSnapshotFragment(packet.data, packet.payloadLength, receivedSnapshots, snapshotAssemblies);
+	if (assembly == nullptr)
+	{
+		return false;
+	}
+	sequenceNumber = assembly->state.sequenceNumber;
+	complete = assembly->IsComplete();
+
+	// Only complete snapshots can be used as baselines
+	if (complete)
+	{
+		receivedSnapshots.Store(assembly->state);
+	}
+
+	// Objects are shown as soon as their fragment arrives, older snapshots are not shown
 	std::lock_guard<std::mutex> lock2(gameDataMutex);
-	memcpy(&gameDataState, packet.data, sizeof(NetworkGameState)); // Copy buffer back into struct
+	if (static_cast<int32_t>(sequenceNumber - gameDataState.sequenceNumber) >= 0 || gameDataState.sequenceNumber == 0)
+	{
+		CopyGameState(gameDataState, assembly->state);
+	}
+	return true;
+}
+
+void SendGameStateAck(SOCKET socket, sockaddr_in address, uint32_t sequenceNumber)
+{
+	NetworkPacket packet;
+	packet.packetID = PacketID::GAME_STATE_ACK;
+	packet.sourcePortNumber = clientPort;
+	packet.destinationPortNumber = address.sin_port;
+	packet.seqNumber = sequenceNumber;								// sequenced channel, older ACKs are dropped
+	SetPacketPayload(packet, &sequenceNumber, sizeof(sequenceNumber));
+	SendPacket(socket, address, packet);
+}
+
+void HandleGameStateAck(uint16_t clientPortID, const NetworkPacket& packet)
+{
+	uint32_t sequenceNumber{};
+	if (packet.payloadLength != sizeof(sequenceNumber))
+		return;
+	memcpy(&sequenceNumber, packet.data, sizeof(sequenceNumber));
+
+	// Only move the baseline forward
+	std::lock_guard<std::mutex> lock(snapshotMutex);
+	ClientSnapshotState& client = clientSnapshots[clientPortID];
+	if (client.ackedSequence == SNAPSHOT_NO_BASELINE || static_cast<int32_t>(sequenceNumber - client.ackedSequence) > 0)
+	{
+		client.ackedSequence = sequenceNumber;
+	}
+	client.rate.OnAcked(sequenceNumber);
 }
 
 
 void SendJoinRequest(SOCKET socket, sockaddr_in address) 
 {
-    std::cout << "Client is sending join request..." << std::endl;
+    LOG_INFO("Client is sending join request...");
 	NetworkPacket packet;
 	packet.packetID = PacketID::JOIN_REQUEST;
 	packet.sourcePortNumber = clientPort;
@@ -523,26 +581,34 @@ void HandleJoinRequest(SOCKET socket, sockaddr_in address, NetworkPacket packet)
 {
 	if (packet.packetID == PacketID::JOIN_REQUEST) 
 	{
-		std::cout << "Player [" << packet.sourcePortNumber << "] is joining the lobby." << std::endl;
+		LOG_INFO("Player [" << packet.sourcePortNumber << "] is joining the lobby.");
 
 		NetworkPacket responsePacket;
 		responsePacket.packetID = PacketID::REQUEST_ACCEPTED;
 		responsePacket.sourcePortNumber = serverPort;
 		responsePacket.destinationPortNumber = packet.sourcePortNumber;
-        SendAck(socket, address, packet);
-		SendPacket(socket, address, responsePacket);
+		SendPacket(socket, address, responsePacket);     // carries the ACK of the join request
        
 	}
 }
 
-void SendInput(SOCKET socket, sockaddr_in address) 
+// Sends the input of a new tick, along with the inputs of the previous ticks
+uint32_t SendInput(SOCKET socket, sockaddr_in address, const PlayerInput& input)
 {
+	// Newest first, the oldest input falls off the end
+	memmove(inputHistory.inputs + 1, inputHistory.inputs, INPUT_REDUNDANCY - 1);
+	inputHistory.inputs[0] = input.Pack();
+	++inputHistory.newestTick;
+	if (inputHistory.count < INPUT_REDUNDANCY)
+		++inputHistory.count;
+
 	NetworkPacket packet;
 	packet.packetID = PacketID::GAME_INPUT;
-	packet.sourcePortNumber = serverPort;
+	packet.sourcePortNumber = clientPort;
 	packet.destinationPortNumber = address.sin_port;
-	strcpy_s(packet.data, "[PLAYER_INPUT_DATA]");
+	SetPacketPayload(packet, &inputHistory, offsetof(InputFrames, inputs) + inputHistory.count);
 	SendPacket(socket, address, packet);
+	return inputHistory.newestTick;
 }
 
 uint16_t GetClientPort()
@@ -550,97 +616,113 @@ uint16_t GetClientPort()
 	return clientPort;
 }
 
-void HandleClientInput(SOCKET serverUDPSocket, uint16_t clientPortID, std::map<uint16_t, PlayerData>& playersData)
+void OpenClientQueues(const std::map<uint16_t, sockaddr_in>& clients)
 {
-	while (true)
+	clientInboxes.clear();
+	std::lock_guard<std::mutex> lock(snapshotMutex);
+	for (auto& [portID, address] : clients)
 	{
-		fd_set readSet;
-		FD_ZERO(&readSet);
-		FD_SET(serverUDPSocket, &readSet);
-
-		timeval timeout{};
-		timeout.tv_sec = 0;
-		timeout.tv_usec = 10000; // 10ms timeout
-
-		int activity = select(0, &readSet, nullptr, nullptr, &timeout);
-
-		if (activity > 0) // Data available
-		{
-            if (!isPlayerConnected[clientPortID]) {
-                std::cout << "[Server] Stopping client thread for " << clientPortID << "\n";
-                break; // so that thread function returns
-            }
-
-			sockaddr_in senderAddress{};
-			NetworkPacket gamePacket = ReceivePacket(serverUDPSocket, senderAddress);
+		clientInboxes[portID] = std::make_unique<ClientInbox>();
+		clientInboxes[portID]->address = address;
+		clientSnapshots[portID].rate.Reset(snapshotRate, GetTimeNow());
+	}
+}
 
-			if (gamePacket.packetID == UINT16_MAX) // Check for invalid packet
-				continue;
+// Reads the packets waiting on the server socket without blocking. Each packet is handed to the
+// queue of the client it came from, so each client's packets are handled together on the next tick
+void ReceiveClientPackets(SOCKET serverUDPSocket)
+{
+	fd_set readSet;
+	FD_ZERO(&readSet);
+	FD_SET(serverUDPSocket, &readSet);
 
-            lastHeardTime[clientPortID] = GetTimeNow();
-            if (!isPlayerConnected[clientPortID])
-            {
-                isPlayerConnected[clientPortID] = true;
-                std::cout << "[Server] Player " << clientPortID << " reconnected (HandleClientInput)\n";
-            }
+	timeval timeout{}; // only polls
 
-            SendAck(serverUDPSocket, senderAddress, gamePacket);
+	// The rest is read on the next call if more than a queue's worth is waiting
+	int drained = 0;
+	while ((HasBufferedDatagrams() || HasReadyPackets() || select(static_cast<int>(serverUDPSocket) + 1, &readSet, nullptr, nullptr, &timeout) > 0) && drained < CLIENT_QUEUE_SIZE)
+	{
+		++drained;
 
-			// Ensure this is from the correct client
-			if (gamePacket.sourcePortNumber != clientPortID)
-				continue;
+		sockaddr_in senderAddress{};
+		NetworkPacket packet = ReceivePacket(serverUDPSocket, senderAddress);
 
-			// Ensure the player's data exists
-			if (playersData.count(clientPortID))
-			{
-				HandlePlayerInput(clientPortID, gamePacket, playersData);
-			}
-			else
+		if (packet.packetID != UINT16_MAX)
+		{
+			// Only accepted from the address the client joined with
+			auto inbox = clientInboxes.find(packet.sourcePortNumber);
+			if (inbox != clientInboxes.end() &&
+				inbox->second->address.sin_addr.s_addr == senderAddress.sin_addr.s_addr &&
+				inbox->second->address.sin_port == senderAddress.sin_port)
 			{
-				std::cerr << "Warning: Received input from unregistered player " << clientPortID << std::endl;
-				return;
+				// Dropped if the queue is full, inputs are repeated in the next packets
+				inbox->second->packets.Push(packet);
 			}
 		}
 
-		// Small sleep to prevent CPU from running at 100%
-		Sleep(1);
+		FD_ZERO(&readSet);
+		FD_SET(serverUDPSocket, &readSet);
 	}
 }
 
-void HandlePlayerInput(uint16_t clientPortID, NetworkPacket& packet, std::map<uint16_t, PlayerData>& playersData)
+void HandleClientPackets(uint16_t clientPortID, std::map<uint16_t, PlayerData>& playersData)
 {
-	// Note: Uncomment to test if the keys are working correctly
-	std::lock_guard<std::mutex> lock(playerDataMutex);
-	PlayerInput& playerInput = playerInputMap[clientPortID];
-	if (packet.packetID == InputKey::NONE)
-	{
-		playersData[clientPortID].transform.velocity = { 0, 0 };
-		playerInput.NoInput();
-	}
-	else if (packet.packetID == InputKey::UP)
-	{
-		playersData[clientPortID].transform.position = { 10, 10 };
-		playerInput.upKey = true;
-	}
-	else if (packet.packetID == InputKey::DOWN)
+	auto inbox = clientInboxes.find(clientPortID);
+	if (inbox == clientInboxes.end() || !isPlayerConnected[clientPortID])
 	{
-		playersData[clientPortID].transform.position = { 20, 20 };
-		playerInput.downKey = true;
+		return;
 	}
-	else if (packet.packetID == InputKey::RIGHT)
+
+	NetworkPacket gamePacket;
+	while (inbox->second->packets.Pop(gamePacket))
 	{
-		playersData[clientPortID].transform.position = { 30, 30 };
-		playerInput.rightKey = true;
+		lastHeardTime[clientPortID] = GetTimeNow();
+
+		if (gamePacket.packetID == GAME_STATE_ACK)
+		{
+			HandleGameStateAck(clientPortID, gamePacket);
+		}
+		// Ensure the player's data exists
+		else if (playersData.count(clientPortID))
+		{
+			HandlePlayerInput(clientPortID, gamePacket);
+		}
+		else
+		{
+			LOG_WARNING("Warning: Received input from unregistered player " << clientPortID);
+		}
 	}
-	else if (packet.packetID == InputKey::LEFT)
+}
+
+// Queues every tick of the redundant input that has not been applied yet, the simulation takes one per step
+void HandlePlayerInput(uint16_t clientPortID, NetworkPacket& packet)
+{
+	InputFrames frames{};
+	if (packet.packetID != PacketID::GAME_INPUT ||
+		packet.payloadLength < offsetof(InputFrames, inputs) || packet.payloadLength > sizeof(InputFrames))
+		return;
+	memcpy(&frames, packet.data, packet.payloadLength);
+	if (packet.payloadLength != offsetof(InputFrames, inputs) + frames.count)
+		return;
+
+	std::lock_guard<std::mutex> lock(playerDataMutex);
+	PlayerInputQueue& queue = playerInputQueueMap[clientPortID];
+	if (static_cast<int32_t>(frames.newestTick - queue.newestTick) <= 0)
+		return;
+
+	// A client further ahead than the queue holds goes on from the oldest tick of this packet
+	if (frames.newestTick - queue.appliedTick > INPUT_QUEUE_SIZE)
+		queue.appliedTick = frames.newestTick - (std::min)(static_cast<uint32_t>(frames.count), static_cast<uint32_t>(INPUT_QUEUE_SIZE));
+
+	// Ticks applied already are skipped, ticks older than the packet's history were lost for good
+	for (uint32_t i = 0; i < frames.count; ++i)
 	{
-		playersData[clientPortID].transform.position = { 40, 40 };
-		playerInput.leftKey = true;
+		uint32_t tick = frames.newestTick - i;
+		if (static_cast<int32_t>(tick - queue.appliedTick) <= 0)
+			break;
+		queue.inputs.Insert(tick) = frames.inputs[i];
 	}
-	else if (packet.packetID == InputKey::SPACE)
-	{
-		playerInput.spaceKey = true;
-    }
+	queue.newestTick = frames.newestTick;
 }
 
 void SendGameStateStart(SOCKET socket, sockaddr_in address, PlayerData& playerData)
@@ -649,11 +731,12 @@ void SendGameStateStart(SOCKET socket, sockaddr_in address, PlayerData& playerDa
 	packet.packetID = PacketID::GAME_STATE_START;
 	packet.sourcePortNumber = serverPort;
 	packet.destinationPortNumber = address.sin_port;
-	PackPlayerData(packet, playerData);
+	GameStart start{ playerData, simulationTickRate };
+	SetPacketPayload(packet, &start, sizeof(GameStart));
 	SendPacket(socket, address, packet);
 }
 
-void ReceiveGameStateStart(SOCKET socket, PlayerData& player, NetworkPacket packet)
+void ReceiveGameStateStart(SOCKET socket, PlayerData& player, uint32_t& tickRate, NetworkPacket packet)
 {
     (void)socket;
     //sockaddr_in address{};
@@ -661,89 +744,98 @@ void ReceiveGameStateStart(SOCKET socket, PlayerData& player, NetworkPacket pack
 
     if (packet.packetID == PacketID::GAME_STATE_START)
     {
-        std::cout << "Game started. Initial game state: " << packet.data << std::endl;
+        LOG_INFO("Game started. Initial game state: " << packet.data);
         UnpackPlayerData(packet, player);
-        std::cout << "Initial Player Position: " << player.transform.position.x << " " << player.transform.position.y << std::endl;
+
+        // The server starts the game from tick 1 of every client
+        inputHistory = InputFrames{};
+
+        GameStart start{};
+        tickRate = SIMULATION_TICK_RATE;
+        if (packet.payloadLength >= sizeof(GameStart))
+        {
+            memcpy(&start, packet.data, sizeof(GameStart));
+            tickRate = std::clamp<uint32_t>(start.simulationTickRate, SIMULATION_MIN_TICK_RATE, SIMULATION_MAX_TICK_RATE);
+        }
+        LOG_INFO("Initial Player Position: " << player.transform.position.x << " " << player.transform.position.y);
     }
 }
 
 
 void BroadcastGameState(SOCKET socket, std::map<uint16_t, sockaddr_in>& clients)
 {
-	while (true)
+	// Kept across calls, both are too large for the stack
+	static NetworkGameState snapshot;
+	static SnapshotFragment fragments[MAX_SNAPSHOT_FRAGMENTS];
+
+	// Take a consistent copy of the game state for this snapshot
 	{
-		Sleep(16); // Approx 60 updates per second (1000ms / 60)
+		std::lock_guard<std::mutex> lock(gameDataMutex);
+		++gameDataState.sequenceNumber;
+		CopyGameState(snapshot, gameDataState);
+	}
 
-		// 1. **Send the full game state to all clients**
-		NetworkPacket responsePacket;
-		responsePacket.packetID = PacketID::GAME_STATE_UPDATE;
-		responsePacket.sourcePortNumber = serverPort;					// Server's port
+	// 1. **Send the game state to all clients, delta compressed per client**
+	NetworkPacket responsePacket;
+	responsePacket.packetID = PacketID::GAME_STATE_UPDATE;
+	responsePacket.sourcePortNumber = serverPort;					// Server's port
 
-		PackGameStateData(responsePacket, gameDataState);
+	// Every fragment of every client leaves in as few system calls as possible
+	uint64_t now = GetTimeNow();
+	BeginSendBatch();
 
-		for (auto& [portID, clientAddr] : clients)
+	for (auto client = clients.begin(); client != clients.end();)
+	{
+		if (!isPlayerConnected[client->first])
 		{
-            if (!isPlayerConnected[portID]) {
-                // remove from clients
-                clients.erase(portID);
-            }
-
-			{
-				responsePacket.destinationPortNumber = portID;			// Client's port
-				SendPacket(socket, clientAddr, responsePacket);
-			}
+			// remove from clients
+			client = clients.erase(client);
+			continue;
 		}
+		auto& [portID, clientAddr] = *client;
+		++client;
 
-	}
-}
-
-// Thread function to receive packets continuously
-void ListenForUpdates(SOCKET socket, sockaddr_in serverAddr, PlayerData& player)
-{
-	while (true)
-	{
-		NetworkPacket receivedPacket = ReceivePacket(socket, serverAddr);
-		if (receivedPacket.packetID == GAME_STATE_UPDATE)
+		uint32_t fragmentCount;
 		{
-			UnpackGateStateData(receivedPacket);
-			for (int i = 0; i < static_cast<int>(gameDataState.objectCount); ++i)
+			std::lock_guard<std::mutex> lock(snapshotMutex);
+			ClientSnapshotState& snapshotState = clientSnapshots[portID];
+			if (snapshotState.rate.Update(now))
 			{
-				if (gameDataState.objects[i].type == ObjectType::OBJ_SHIP && gameDataState.objects[i].identifier == clientPort)
-				{
-					player.transform = gameDataState.objects[i].transform;
-					for (int j = 0; j < static_cast<int>(gameDataState.playerCount); ++j)
-					{
-						if (gameDataState.playerData[j].identifier == clientPort)
-						{
-							player.stats = gameDataState.playerData[j];
-						}
-					}
-				}
+				LOG_INFO("[Server] Client " << portID << " snapshot rate: " << snapshotState.rate.GetRate() << " Hz (loss "
+				         << snapshotState.rate.GetLoss() * 100.0f << "%, " << snapshotState.rate.GetBandwidth() << " B/s)");
 			}
 
-        } else if (receivedPacket.packetID == REQUEST_ACCEPTED) {
-
-            std::cout << "Joined the lobby successfully!" << std::endl;
-            std::cout << "Waiting for lobby to start..." << std::endl;
-
-            gGameStateNext = GS_LOBBY;
-            
-        } else if (receivedPacket.packetID == GAME_STATE_START) {
-
-            ReceiveGameStateStart(udpClientSocket, clientData, receivedPacket);
-            gGameStateNext = GS_ASTEROIDS;
+			// A weak link skips snapshots, so the ones it is sent can arrive whole
+			if (!snapshotState.rate.IsSendDue(snapshot.sequenceNumber))
+				continue;
 
-        } else if (receivedPacket.packetID == SEND_CLIENT_COUNT) {
+			// The client replays its inputs after this one on top of its ship
+			{
+				std::lock_guard<std::mutex> inputLock(playerDataMutex);
+				snapshot.inputTick = playerInputQueueMap[portID].appliedTick;
+			}
+			fragmentCount = PackGameStateData(fragments, snapshot, portID, snapshotState);
+		}
 
-            ReceiveClientCount(receivedPacket);
-        }
+		// Each fragment is its own datagram, so losing one does not hold back the others
+		// They share the snapshot's sequence number, so older snapshots are dropped on arrival
+		size_t bytes = 0;
+		responsePacket.seqNumber = snapshot.sequenceNumber;
+		for (uint32_t i = 0; i < fragmentCount; ++i)
+		{
+			SetPacketPayload(responsePacket, fragments[i].data, fragments[i].size);
+			responsePacket.destinationPortNumber = portID;			// Client's port
+			SendPacket(socket, clientAddr, responsePacket);
+			bytes += GetPacketSize(responsePacket);
+		}
 
-		std::cout << "Pos: " << player.transform.position.x << " " << player.transform.position.y << std::endl;
+		std::lock_guard<std::mutex> lock(snapshotMutex);
+		clientSnapshots[portID].rate.OnSent(snapshot.sequenceNumber, bytes, now);
 	}
 
+	FlushSendBatch();
 }
 
-
 void BroadcastClientCount(SOCKET socket, std::map<uint16_t, sockaddr_in>& clients) {
 
     if (clientCountGlobal == 0) {
@@ -757,7 +849,7 @@ void BroadcastClientCount(SOCKET socket, std::map<uint16_t, sockaddr_in>& client
         packet.destinationPortNumber = portID;			// Client's port
         packet.flags = 0;
         packet.packetID = SEND_CLIENT_COUNT;
-        std::memcpy(packet.data, (void*)&clientCountGlobal, sizeof(clientCountGlobal));
+        SetPacketPayload(packet, &clientCountGlobal, sizeof(clientCountGlobal));
         SendPacket(socket, clientAddr, packet);
     }
 
@@ -770,64 +862,35 @@ void ReceiveClientCount(NetworkPacket packet) {
     }
 }
 
-void GameLoop(std::map<uint16_t, sockaddr_in>& clients)
+void UpdateGameLoop(std::map<uint16_t, sockaddr_in>& clients)
 {
-
 	UNREFERENCED_PARAMETER(clients);
 
-	while (true)
-	{
+	// Set the simulated world inside the gameState
+	WriteSimulationState(gameDataState);
 
+    // --------------- Timeout Check ---------------
+    uint64_t now = GetTimeNow();
 
-		// Set the player data inside the gameState
-		for (auto& [portID, playerData] : playerDataMap)
-		{
-			for (int i = 0; i < static_cast<int>(gameDataState.objectCount); ++i)
-			{
-				if (gameDataState.objects[i].type == ObjectType::OBJ_SHIP && gameDataState.objects[i].identifier == portID)
-				{
-					gameDataState.objects[i].transform = playerData.transform;
-					for (int j = 0; j < static_cast<int>(gameDataState.playerCount); ++j)
-					{
-						if (gameDataState.playerData[j].identifier == portID)
-						{
-							gameDataState.playerData[j] = playerData.stats;
-							break;
-						}
-					}
-					break;
-				}
-			}
-			std::cout << "Client: " << portID << " position: " << playerData.transform.position.x << " " << playerData.transform.position.y << std::endl;
-		}
-		
-        // --------------- Timeout Check ---------------
-        uint64_t now = GetTimeNow();
+    for (auto& [portID, connected] : isPlayerConnected)
+    {
+        if (!connected) continue; // current client at portID is already disconnected
 
-        for (auto& [portID, connected] : isPlayerConnected)
+        // if it's been more than DISCONNECT_THRESHOLD_MS since server has heard from them
+        if (now - lastHeardTime[portID] > DISCONNECT_THRESHOLD_MS)
         {
-            if (!connected) continue; // current client at portID is already disconnected
-
-            // if it's been more than DISCONNECT_THRESHOLD_MS since server has heard from them
-            if (now - lastHeardTime[portID] > DISCONNECT_THRESHOLD_MS)
-            {
-                connected = false; // mark them as disconnected
-                std::cout << "[Server] Player " << portID << " timed out -> disconnected\n";
-            }
+            connected = false; // mark them as disconnected
+            LOG_INFO("[Server] Player " << portID << " timed out -> disconnected");
         }
-        // --------------- End of Timeout Check ------------
-
-        Sleep(16); // small throttle to avoid CPU hog
-	}
-
+    }
+    // --------------- End of Timeout Check ------------
 }
 
 void PackLeaderboardData(NetworkPacket& packet)
 {
 	std::lock_guard<std::mutex> lock1(packetMutex);
 	std::lock_guard<std::mutex> lock2(leaderboardMutex);
-	memset(packet.data, 0, DEFAULT_BUFLEN);							// Ensure buffer is cleared
-	memcpy(packet.data, &leaderboard, sizeof(NetworkLeaderboard));	// Copy struct into buffer
+	SetPacketPayload(packet, &leaderboard, sizeof(NetworkLeaderboard));	// Copy struct into buffer
 }
 
 // Unpacking the data from the network packet into the leaderboard
@@ -868,81 +931,6 @@ void ReceiveLeaderboard(SOCKET socket)
 	// Leaderboard is updated, can be shown to the players
 }
 
-void Render(NetworkGameState& gameState)
-{
-	UNREFERENCED_PARAMETER(gameState);
-
-    // Initialize the system
-    AESysInit(g_instanceH, g_show, 800, 600, 1, 60, false, NULL);
-
-    pFont = (int)AEGfxCreateFont("Resources/Arial Italic.ttf", fontSize);
-
-    // Changing the window title
-    AESysSetWindowTitle("Asteroids!");
-
-    //set background color
-    AEGfxSetBackgroundColor(0.0f, 0.0f, 0.0f);
-
-    // set starting game state to asteroid
-    //GameStateMgrInit(GS_ASTEROIDS);
-    GameStateMgrInit(GS_MAINMENU);  // Start at the main Menu
-
-    // breaks this loop if game state set to quit
-    while (gGameStateCurr != GS_QUIT)
-    {
-        // reset the system modules
-        AESysReset();
-
-        // If not restarting, load the gamestate
-        if (gGameStateCurr != GS_RESTART)
-        {
-            GameStateMgrUpdate();
-            GameStateLoad();
-        }
-        else
-        {
-            gGameStateNext = gGameStateCurr = gGameStatePrev;
-        }
-
-        // Initialize the gamestate
-        GameStateInit();
-
-        // main game loop
-        while (gGameStateCurr == gGameStateNext) {
-
-            AESysFrameStart(); // start of frame
-
-            GameStateUpdate(); // update current game state
-
-            GameStateDraw(); // draw current game state
-
-            AESysFrameEnd(); // end of frame
-
-            // check if forcing the application to quit
-            if (AESysDoesWindowExist() == false)
-            {
-                gGameStateNext = GS_QUIT;
-            }
-
-            g_dt = static_cast<f32>(AEFrameRateControllerGetFrameTime()); // get delta time
-            g_appTime += g_dt; // accumulate application time
-        }
-
-        GameStateFree(); // free current game state
-
-        // unload current game state unless set to restart
-        if (gGameStateNext != GS_RESTART)
-            GameStateUnload();
-
-        // set prev and curr for the next game states
-        gGameStatePrev = gGameStateCurr;
-        gGameStateCurr = gGameStateNext;
-    }
-
-    // free the system
-    AESysExit();
-}
-
 uint64_t GetTimeNow() {
     return std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::steady_clock::now().time_since_epoch())
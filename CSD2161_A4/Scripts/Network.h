@@ -1,18 +1,7 @@
 #ifndef NETWORK
 #define NETWORK // header guards
 
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-
-#include "Windows.h"		// Entire Win32 API...
-// #include "winsock2.h"	// ...or Winsock alone
-#include "ws2tcpip.h"		// getaddrinfo()
-
-// Tell the Visual Studio linker to include the following library in linking.
-// Alternatively, we could add this file to the linker command-line parameters,
-// but including it in the source code simplifies the configuration.
-#pragma comment(lib, "ws2_32.lib")
+#include "Platform.h"			// sockets of the platform
 
 #include <iostream>			// cout, cerr
 #include <string>			// string
@@ -23,9 +12,13 @@
 #include <mutex>			// mutex
 #include <set>              // set
 #include <unordered_map>    // unordered map
-#include <AEEngine.h>		// AEVec2
+#include <cstddef>          // offsetof
+#include <atomic>           // atomic
+#include <memory>           // unique_ptr
+#include <AEVec2.h>			// AEVec2
 #include "Math.h"
 #include "GameData.h"
+#include "NetworkSnapshot.h"
 
 #undef WINSOCK_VERSION		// fix for macro redefinition
 #define WINSOCK_VERSION     2
@@ -37,8 +30,15 @@
 #define MAX_QUEUE_SLOTS		20
 
 #define DEFAULT_BUFLEN		4096
-#define TIMEOUT_MS		    1000
+#define TIMEOUT_MS		    1000            // retransmission timeout until the round trip time is measured
 #define TIMEOUT_MS_MAX      10000
+#define RTO_MIN_MS          30              // shortest retransmission timeout, above ACK_DELAY_MS
+#define RTO_MAX_MS          2000            // longest retransmission timeout after backing off
+#define RTT_ALPHA           0.125f          // weight of a new sample in the smoothed round trip time
+#define RTT_BETA            0.25f           // weight of a new sample in the round trip time variation
+
+#define ACK_NONE            UINT32_MAX      // ackNumber of a peer that has received nothing yet
+#define ACK_DELAY_MS        20              // longest wait for outgoing traffic to carry an ACK
 
 #define WIND_SIZE           32
 #define SEQ_NUM_MIN         0
@@ -62,9 +62,19 @@ enum PacketID
     GAME_INPUT = 0x25,
     GAME_STATE_START = 0x26,
     GAME_STATE_UPDATE = 0x27,
+    GAME_STATE_ACK = 0x28,
     LEADERBOARD = 0x29
 };
 
+// Delivery guarantees of a packet, decided by its PacketID
+enum class Channel
+{
+    RELIABLE_ORDERED,       // resent until acknowledged, handed out in the order it was sent
+    RELIABLE_UNORDERED,     // resent until acknowledged, handed out as soon as it arrives
+    UNRELIABLE_SEQUENCED,   // never resent, dropped if older than one already received
+    UNRELIABLE              // never resent, the sender adds redundancy if needed
+};
+
 enum InputKey
 {
     NONE,
@@ -83,6 +93,8 @@ enum Datatype
     SCORE
 };
 
+#pragma pack(push, 1)
+// Only the header and the first payloadLength bytes of data are sent on the wire
 struct NetworkPacket
 {
     NetworkPacket()
@@ -92,12 +104,40 @@ struct NetworkPacket
 
     uint8_t flags = 0;
     uint32_t seqNumber;
+    uint32_t ackNumber = ACK_NONE;      // latest sequence number received from the peer
+    uint32_t ackBits = 0;               // bit i set if ackNumber - 1 - i was also received
 
     uint16_t packetID;
     uint16_t sourcePortNumber;
     uint16_t destinationPortNumber;
+    uint16_t payloadLength = 0;         // number of bytes used in data
     char data[DEFAULT_BUFLEN];
 };
+#pragma pack(pop)
+
+#define NETWORK_HEADER_SIZE static_cast<int>(offsetof(NetworkPacket, data))
+
+#define CLIENT_QUEUE_SIZE   64      // packets held per client by the event loop until the next simulation step
+
+#define INPUT_REDUNDANCY    8       // ticks of input repeated in every GAME_INPUT packet
+
+#pragma pack(push, 1)
+// Payload of GAME_INPUT. inputs[i] holds the packed PlayerInput of tick newestTick - i, so any
+// packet lost in a burst shorter than INPUT_REDUNDANCY is recovered from the next one
+struct InputFrames
+{
+    uint32_t newestTick;
+    uint8_t count;                      // number of inputs used
+    uint8_t inputs[INPUT_REDUNDANCY];
+};
+
+// Payload of GAME_STATE_START. The client sends one input tick per step of the server's simulation
+struct GameStart
+{
+    PlayerData player;
+    uint32_t simulationTickRate;        // steps per second, each applies one tick of input
+};
+#pragma pack(pop)
 
 struct PlayerData;
 
@@ -106,17 +146,12 @@ extern NetworkType networkType;
 extern sockaddr_in serverTargetAddress;
 extern sockaddr_in clientTargetAddress;
 extern uint16_t serverPort;
+extern uint16_t clientPort;
 extern SOCKET udpServerSocket;
 extern SOCKET udpClientSocket;
 
-extern uint32_t sendBase;
-extern uint32_t recvBase;
-extern std::map<uint32_t, NetworkPacket> sendBuffer;               // Packets awaiting ACK
-extern std::set<uint32_t> ackedPackets;                            // Tracks received ACKs
-extern std::map<uint32_t, NetworkPacket> recvBuffer;               // Stores received packets
-extern std::map<uint32_t, uint64_t> timers;                        // Timeout tracking for packets waiting to be ACK-ed
-
 extern uint32_t clientCountGlobal;
+extern uint32_t snapshotRate;
 
 void AttachConsoleWindow();
 void FreeConsoleWindow();
@@ -126,7 +161,10 @@ int StartServer();
 int ConnectToServer();
 void Disconnect(SOCKET& socket);
 
+Channel GetPacketChannel(uint16_t packetID);
+
 void RetransmitPacket();
+bool SendDatagram(SOCKET socket, const sockaddr_in& address, const NetworkPacket& packet);
 bool SendPacket(SOCKET socket, sockaddr_in address, NetworkPacket packet, bool is_retransmit = false);
 NetworkPacket ReceivePacket(SOCKET socket, sockaddr_in& address);
 
@@ -136,22 +174,34 @@ void HandleConnectionRequest(SOCKET socket, sockaddr_in address, NetworkPacket p
 
 void SendQuitRequest(SOCKET socket, sockaddr_in address);
 
+int GetPacketSize(const NetworkPacket& packet);
+void SetPacketPayload(NetworkPacket& packet, const void* payload, size_t size);
+
 void PackPlayerData(NetworkPacket& packet, const PlayerData& player);
 void UnpackPlayerData(const NetworkPacket& packet, PlayerData& player);
 
-void PackGameStateData(NetworkPacket& packet, const NetworkGameState& player);
-void UnpackGateStateData(const NetworkPacket& packet);
+uint32_t PackGameStateData(SnapshotFragment* fragments, const NetworkGameState& gameState, uint16_t clientPortID, ClientSnapshotState& client);
+bool UnpackGateStateData(const NetworkPacket& packet, uint32_t& sequenceNumber, bool& complete);
+
+void SendGameStateAck(SOCKET socket, sockaddr_in address, uint32_t sequenceNumber);
+void HandleGameStateAck(uint16_t clientPortID, const NetworkPacket& packet);
 
 void SendJoinRequest(SOCKET socket, sockaddr_in address);
 void HandleJoinRequest(SOCKET socket, sockaddr_in address, NetworkPacket packet);
 
-void SendInput(SOCKET socket, sockaddr_in address);
-void HandleClientInput(SOCKET serverUDPSocket, uint16_t clientPortID, std::map<uint16_t, PlayerData>& playersData);
-void HandlePlayerInput(uint16_t clientPortID, NetworkPacket& packet, std::map<uint16_t, PlayerData>& playersData);
+// Returns the tick of the input, the server reports the newest tick it applied in each snapshot
+uint32_t SendInput(SOCKET socket, sockaddr_in address, const PlayerInput& input);
+// Functions for the server loop once the game started, packets are queued per client as they
+// arrive and handled on the next tick. OpenClientQueues must be called with the final clients
+void OpenClientQueues(const std::map<uint16_t, sockaddr_in>& clients);
+void ReceiveClientPackets(SOCKET serverUDPSocket);
+void HandleClientPackets(uint16_t clientPortID, std::map<uint16_t, PlayerData>& playersData);
+void HandlePlayerInput(uint16_t clientPortID, NetworkPacket& packet);
 
 void SendGameStateStart(SOCKET socket, sockaddr_in address, PlayerData& playerData);
-void ReceiveGameStateStart(SOCKET socket, PlayerData& player, NetworkPacket packet);
+void ReceiveGameStateStart(SOCKET socket, PlayerData& player, uint32_t& tickRate, NetworkPacket packet);
 
+// Takes a snapshot of the game state and sends it to each client whose snapshot rate is due
 void BroadcastGameState(SOCKET socket, std::map<uint16_t, sockaddr_in>& clients);
 void ListenForUpdates(SOCKET udpSocket, sockaddr_in serverAddr, PlayerData& clientData);
 
@@ -165,8 +215,8 @@ void UnpackLeaderboardData(NetworkPacket const& packet);
 void BroadcastLeaderboard(SOCKET socket, std::map<uint16_t, sockaddr_in>& clients);
 void ReceiveLeaderboard(SOCKET socket);
 
-void GameLoop(std::map<uint16_t, sockaddr_in>& clients);
-void Render(NetworkGameState& gameState);
+void UpdateGameLoop(std::map<uint16_t, sockaddr_in>& clients);
+void Render();
 
 uint16_t GetClientPort();
 
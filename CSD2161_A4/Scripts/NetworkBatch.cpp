@@ -0,0 +1,194 @@
+/******************************************************************************/
+/*!
+\file		NetworkBatch.cpp
+\author
+\par
+\date
+\brief		This file contains the definitions of the batching of datagrams
+			sent and received on Linux, and the direct fallback used on the
+			other platforms.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "NetworkBatch.h"
+
+#include "Logger.h"			// LOG_ERROR
+
+#ifdef __linux__
+
+#include <sys/socket.h>		// sendmmsg, recvmmsg
+#include <memory>			// std::unique_ptr
+
+// Datagrams queued by a thread, sent together by FlushSendBatch
+struct SendBatch
+{
+	SOCKET socket = INVALID_SOCKET;
+	bool active = false;
+	unsigned int count = 0;
+	NetworkPacket packets[DATAGRAM_BATCH_SIZE];
+	sockaddr_in addresses[DATAGRAM_BATCH_SIZE];
+	iovec vectors[DATAGRAM_BATCH_SIZE];
+	mmsghdr messages[DATAGRAM_BATCH_SIZE];
+};
+
+// Datagrams read by a thread with one recvmmsg, handed out one by one by ReceiveDatagram
+struct ReceiveBatch
+{
+	unsigned int count = 0;
+	unsigned int next = 0;
+	NetworkPacket packets[DATAGRAM_BATCH_SIZE];
+	sockaddr_in addresses[DATAGRAM_BATCH_SIZE];
+	iovec vectors[DATAGRAM_BATCH_SIZE];
+	mmsghdr messages[DATAGRAM_BATCH_SIZE];
+};
+
+// Allocated on first use, most threads never send or receive
+static thread_local std::unique_ptr<SendBatch> sendBatch;
+static thread_local std::unique_ptr<ReceiveBatch> receiveBatch;
+
+void BeginSendBatch()
+{
+	if (!sendBatch)
+		sendBatch = std::make_unique<SendBatch>();
+
+	sendBatch->active = true;
+	sendBatch->count = 0;
+}
+
+// Sends the queued datagrams, keeps batching
+static int SendQueuedDatagrams()
+{
+	SendBatch& batch = *sendBatch;
+	unsigned int sent = 0;
+
+	while (sent < batch.count)
+	{
+		int result = sendmmsg(batch.socket, batch.messages + sent, batch.count - sent, 0);
+		if (result <= 0)
+		{
+			// The datagram that failed is dropped, the others are still sent
+			LOG_ERROR("Failed to send game data. Error: " << WSAGetLastError());
+			++sent;
+			continue;
+		}
+		sent += static_cast<unsigned int>(result);
+	}
+
+	batch.count = 0;
+	return static_cast<int>(sent);
+}
+
+bool QueueDatagram(SOCKET socket, const sockaddr_in& address, const NetworkPacket& packet)
+{
+	if (!sendBatch || !sendBatch->active)
+		return false;
+
+	SendBatch& batch = *sendBatch;
+
+	// A batch is sent on one socket
+	if (batch.count == DATAGRAM_BATCH_SIZE || (batch.count > 0 && batch.socket != socket))
+		SendQueuedDatagrams();
+
+	unsigned int i = batch.count++;
+	batch.socket = socket;
+	batch.addresses[i] = address;
+	memcpy(&batch.packets[i], &packet, GetPacketSize(packet));
+
+	batch.vectors[i].iov_base = &batch.packets[i];
+	batch.vectors[i].iov_len = GetPacketSize(packet);
+	batch.messages[i] = {};
+	batch.messages[i].msg_hdr.msg_name = &batch.addresses[i];
+	batch.messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+	batch.messages[i].msg_hdr.msg_iov = &batch.vectors[i];
+	batch.messages[i].msg_hdr.msg_iovlen = 1;
+	return true;
+}
+
+int FlushSendBatch()
+{
+	if (!sendBatch || !sendBatch->active)
+		return 0;
+
+	int sent = SendQueuedDatagrams();
+	sendBatch->active = false;
+	return sent;
+}
+
+int ReceiveDatagram(SOCKET socket, NetworkPacket& packet, sockaddr_in& address)
+{
+	if (!receiveBatch)
+		receiveBatch = std::make_unique<ReceiveBatch>();
+
+	ReceiveBatch& batch = *receiveBatch;
+
+	if (batch.next == batch.count)
+	{
+		for (unsigned int i = 0; i < DATAGRAM_BATCH_SIZE; ++i)
+		{
+			batch.vectors[i].iov_base = &batch.packets[i];
+			batch.vectors[i].iov_len = sizeof(NetworkPacket);
+			batch.messages[i] = {};
+			batch.messages[i].msg_hdr.msg_name = &batch.addresses[i];
+			batch.messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+			batch.messages[i].msg_hdr.msg_iov = &batch.vectors[i];
+			batch.messages[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		// Waits for the first datagram only, then takes whatever else is already queued
+		int result = recvmmsg(socket, batch.messages, DATAGRAM_BATCH_SIZE, MSG_WAITFORONE, nullptr);
+		batch.next = batch.count = 0;
+		if (result <= 0)
+			return SOCKET_ERROR;
+		batch.count = static_cast<unsigned int>(result);
+	}
+
+	unsigned int i = batch.next++;
+	int size = static_cast<int>(batch.messages[i].msg_len);
+	memcpy(&packet, &batch.packets[i], size);
+	address = batch.addresses[i];
+	return size;
+}
+
+bool HasBufferedDatagrams()
+{
+	return receiveBatch && receiveBatch->next < receiveBatch->count;
+}
+
+#else
+
+// Without sendmmsg and recvmmsg every datagram is sent and received on its own
+
+void BeginSendBatch()
+{
+}
+
+bool QueueDatagram(SOCKET socket, const sockaddr_in& address, const NetworkPacket& packet)
+{
+	UNREFERENCED_PARAMETER(socket);
+	UNREFERENCED_PARAMETER(address);
+	UNREFERENCED_PARAMETER(packet);
+	return false;
+}
+
+int FlushSendBatch()
+{
+	return 0;
+}
+
+int ReceiveDatagram(SOCKET socket, NetworkPacket& packet, sockaddr_in& address)
+{
+	socklen_t addressSize = sizeof(address);
+	return recvfrom(socket, (char*)&packet, sizeof(packet), 0, (sockaddr*)&address, &addressSize);
+}
+
+bool HasBufferedDatagrams()
+{
+	return false;
+}
+
+#endif
@@ -0,0 +1,46 @@
+/******************************************************************************/
+/*!
+\file		NetworkBatch.h
+\author
+\par
+\date
+\brief		This file declares the batching of datagrams under SendDatagram
+			and ReceivePacket. On Linux a batch is sent with one sendmmsg
+			and received with one recvmmsg, elsewhere every datagram is its
+			own sendto or recvfrom.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef NETWORK_BATCH
+#define NETWORK_BATCH // header guard
+
+#include "Network.h"		// NetworkPacket, SOCKET, sockaddr_in
+
+#define DATAGRAM_BATCH_SIZE		64		// datagrams sent or received by one system call
+
+// Batches belong to the calling thread, so a thread only batches the datagrams it sends itself
+
+// Function to start queueing the datagrams sent by this thread instead of sending them at once
+void BeginSendBatch();
+
+// Function to queue the datagram if this thread started a batch. Returns false if it must be sent
+// directly. A full batch is flushed before queueing
+bool QueueDatagram(SOCKET socket, const sockaddr_in& address, const NetworkPacket& packet);
+
+// Function to send every queued datagram and stop batching. Returns the number of datagrams it sent
+int FlushSendBatch();
+
+// Function to read one datagram, taken from the batch of this thread if one is left. When the batch
+// is empty it blocks until at least one datagram arrives, then reads every one that is waiting
+// Returns the number of bytes received or SOCKET_ERROR
+int ReceiveDatagram(SOCKET socket, NetworkPacket& packet, sockaddr_in& address);
+
+// Returns true if datagrams already read by this thread are waiting to be handed out. The socket
+// does not show them as readable anymore, so callers waiting on select must check this first
+bool HasBufferedDatagrams();
+
+#endif
@@ -0,0 +1,289 @@
+/******************************************************************************/
+/*!
+\file		NetworkBitPacker.cpp
+\author
+\par
+\date
+\brief		This file contains the definitions of the bit level writer and
+			reader, and the quantisation of NetworkTransform fields.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "NetworkBitPacker.h"
+
+#include <cstring>					// memcpy
+#include <cmath>					// floorf
+
+BitWriter::BitWriter(char* buffer, size_t capacity) :
+	_buffer{ reinterpret_cast<uint8_t*>(buffer) },
+	_capacity{ capacity },
+	_bitPosition{ 0 },
+	_overflow{ false }
+{
+}
+
+void BitWriter::WriteBits(uint32_t value, uint32_t bits)
+{
+	if (_overflow || _bitPosition + bits > _capacity * 8)
+	{
+		_overflow = true;
+		return;
+	}
+
+	// Fill the current byte, then move on to the next one
+	while (bits > 0)
+	{
+		size_t byte = _bitPosition >> 3;
+		uint32_t offset = _bitPosition & 7;
+		uint32_t count = (8 - offset < bits) ? 8 - offset : bits;
+
+		if (offset == 0)
+		{
+			_buffer[byte] = 0;
+		}
+		_buffer[byte] |= static_cast<uint8_t>((value & ((1u << count) - 1)) << offset);
+
+		value >>= count;
+		bits -= count;
+		_bitPosition += count;
+	}
+}
+
+void BitWriter::WriteBool(bool value)
+{
+	WriteBits(value ? 1 : 0, 1);
+}
+
+void BitWriter::WriteFloat(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	WriteBits(bits, 32);
+}
+
+size_t BitWriter::GetBytesWritten() const
+{
+	return (_bitPosition + 7) >> 3;
+}
+
+size_t BitWriter::GetBitsRemaining() const
+{
+	return _overflow ? 0 : _capacity * 8 - _bitPosition;
+}
+
+bool BitWriter::HasOverflowed() const
+{
+	return _overflow;
+}
+
+BitReader::BitReader(char const* buffer, size_t size) :
+	_buffer{ reinterpret_cast<uint8_t const*>(buffer) },
+	_size{ size },
+	_bitPosition{ 0 },
+	_overflow{ false }
+{
+}
+
+uint32_t BitReader::ReadBits(uint32_t bits)
+{
+	if (_overflow || _bitPosition + bits > _size * 8)
+	{
+		_overflow = true;
+		return 0;
+	}
+
+	uint32_t value = 0;
+	uint32_t shift = 0;
+	while (bits > 0)
+	{
+		size_t byte = _bitPosition >> 3;
+		uint32_t offset = _bitPosition & 7;
+		uint32_t count = (8 - offset < bits) ? 8 - offset : bits;
+
+		uint32_t part = (_buffer[byte] >> offset) & ((1u << count) - 1);
+		value |= part << shift;
+
+		shift += count;
+		bits -= count;
+		_bitPosition += count;
+	}
+	return value;
+}
+
+bool BitReader::ReadBool()
+{
+	return ReadBits(1) != 0;
+}
+
+float BitReader::ReadFloat()
+{
+	uint32_t bits = ReadBits(32);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+bool BitReader::HasOverflowed() const
+{
+	return _overflow;
+}
+
+uint32_t QuantizeFloat(float value, float min, float max, uint32_t bits)
+{
+	uint32_t steps = (1u << bits) - 1;
+
+	// Clamp into range, values outside the playfield are not representable
+	value = (value < min) ? min : (value > max) ? max : value;
+
+	float normalised = (value - min) / (max - min);
+	return static_cast<uint32_t>(normalised * steps + 0.5f);
+}
+
+float DequantizeFloat(uint32_t value, float min, float max, uint32_t bits)
+{
+	uint32_t steps = (1u << bits) - 1;
+	return min + (max - min) * (static_cast<float>(value) / steps);
+}
+
+uint32_t QuantizeAngle(float angle, uint32_t bits)
+{
+	uint32_t steps = 1u << bits;
+
+	// Map [-PI, PI) onto [0, 1) turns, wrapping angles outside that range
+	float turns = (angle + PI) / TWO_PI;
+	turns -= floorf(turns);
+
+	return static_cast<uint32_t>(turns * steps + 0.5f) & (steps - 1);
+}
+
+float DequantizeAngle(uint32_t value, uint32_t bits)
+{
+	uint32_t steps = 1u << bits;
+	return static_cast<float>(value) * TWO_PI / steps - PI;
+}
+
+bool GetFixedScale(ObjectType type, AEVec2& scale)
+{
+	switch (type)
+	{
+	case ObjectType::OBJ_SHIP:
+		scale = AEVec2{ SHIP_SCALE_X, SHIP_SCALE_Y };
+		return true;
+	case ObjectType::OBJ_BULLET:
+		scale = AEVec2{ BULLET_SCALE_X, BULLET_SCALE_Y };
+		return true;
+	case ObjectType::OBJ_WALL:
+		scale = AEVec2{ WALL_SCALE_X, WALL_SCALE_Y };
+		return true;
+	default:
+		return false;
+	}
+}
+
+void WritePosition(BitWriter& writer, AEVec2 const& position)
+{
+	writer.WriteBits(QuantizeFloat(position.x, POSITION_MIN_X, POSITION_MAX_X, POSITION_BITS), POSITION_BITS);
+	writer.WriteBits(QuantizeFloat(position.y, POSITION_MIN_Y, POSITION_MAX_Y, POSITION_BITS), POSITION_BITS);
+}
+
+void WriteVelocity(BitWriter& writer, AEVec2 const& velocity)
+{
+	writer.WriteBits(QuantizeFloat(velocity.x, -VELOCITY_MAX, VELOCITY_MAX, VELOCITY_BITS), VELOCITY_BITS);
+	writer.WriteBits(QuantizeFloat(velocity.y, -VELOCITY_MAX, VELOCITY_MAX, VELOCITY_BITS), VELOCITY_BITS);
+}
+
+void WriteRotation(BitWriter& writer, float rotation)
+{
+	writer.WriteBits(QuantizeAngle(rotation, ROTATION_BITS), ROTATION_BITS);
+}
+
+void WriteScale(BitWriter& writer, AEVec2 const& scale)
+{
+	writer.WriteBits(QuantizeFloat(scale.x, 0.0f, SCALE_MAX, SCALE_BITS), SCALE_BITS);
+	writer.WriteBits(QuantizeFloat(scale.y, 0.0f, SCALE_MAX, SCALE_BITS), SCALE_BITS);
+}
+
+AEVec2 ReadPosition(BitReader& reader)
+{
+	AEVec2 position;
+	position.x = DequantizeFloat(reader.ReadBits(POSITION_BITS), POSITION_MIN_X, POSITION_MAX_X, POSITION_BITS);
+	position.y = DequantizeFloat(reader.ReadBits(POSITION_BITS), POSITION_MIN_Y, POSITION_MAX_Y, POSITION_BITS);
+	return position;
+}
+
+AEVec2 ReadVelocity(BitReader& reader)
+{
+	AEVec2 velocity;
+	velocity.x = DequantizeFloat(reader.ReadBits(VELOCITY_BITS), -VELOCITY_MAX, VELOCITY_MAX, VELOCITY_BITS);
+	velocity.y = DequantizeFloat(reader.ReadBits(VELOCITY_BITS), -VELOCITY_MAX, VELOCITY_MAX, VELOCITY_BITS);
+	return velocity;
+}
+
+float ReadRotation(BitReader& reader)
+{
+	return DequantizeAngle(reader.ReadBits(ROTATION_BITS), ROTATION_BITS);
+}
+
+AEVec2 ReadScale(BitReader& reader)
+{
+	AEVec2 scale;
+	scale.x = DequantizeFloat(reader.ReadBits(SCALE_BITS), 0.0f, SCALE_MAX, SCALE_BITS);
+	scale.y = DequantizeFloat(reader.ReadBits(SCALE_BITS), 0.0f, SCALE_MAX, SCALE_BITS);
+	return scale;
+}
+
+NetworkTransform QuantizeTransform(NetworkTransform const& transform, ObjectType type)
+{
+	NetworkTransform result;
+
+	result.position.x = DequantizeFloat(QuantizeFloat(transform.position.x, POSITION_MIN_X, POSITION_MAX_X, POSITION_BITS),
+										POSITION_MIN_X, POSITION_MAX_X, POSITION_BITS);
+	result.position.y = DequantizeFloat(QuantizeFloat(transform.position.y, POSITION_MIN_Y, POSITION_MAX_Y, POSITION_BITS),
+										POSITION_MIN_Y, POSITION_MAX_Y, POSITION_BITS);
+	result.velocity.x = DequantizeFloat(QuantizeFloat(transform.velocity.x, -VELOCITY_MAX, VELOCITY_MAX, VELOCITY_BITS),
+										-VELOCITY_MAX, VELOCITY_MAX, VELOCITY_BITS);
+	result.velocity.y = DequantizeFloat(QuantizeFloat(transform.velocity.y, -VELOCITY_MAX, VELOCITY_MAX, VELOCITY_BITS),
+										-VELOCITY_MAX, VELOCITY_MAX, VELOCITY_BITS);
+	result.rotation = DequantizeAngle(QuantizeAngle(transform.rotation, ROTATION_BITS), ROTATION_BITS);
+
+	if (!GetFixedScale(type, result.scale))
+	{
+		result.scale.x = DequantizeFloat(QuantizeFloat(transform.scale.x, 0.0f, SCALE_MAX, SCALE_BITS), 0.0f, SCALE_MAX, SCALE_BITS);
+		result.scale.y = DequantizeFloat(QuantizeFloat(transform.scale.y, 0.0f, SCALE_MAX, SCALE_BITS), 0.0f, SCALE_MAX, SCALE_BITS);
+	}
+
+	return result;
+}
+
+void WriteTransform(BitWriter& writer, NetworkTransform const& transform, ObjectType type)
+{
+	AEVec2 fixedScale;
+
+	WritePosition(writer, transform.position);
+	WriteVelocity(writer, transform.velocity);
+	WriteRotation(writer, transform.rotation);
+	if (!GetFixedScale(type, fixedScale))
+	{
+		WriteScale(writer, transform.scale);
+	}
+}
+
+NetworkTransform ReadTransform(BitReader& reader, ObjectType type)
+{
+	NetworkTransform transform;
+
+	transform.position = ReadPosition(reader);
+	transform.velocity = ReadVelocity(reader);
+	transform.rotation = ReadRotation(reader);
+	if (!GetFixedScale(type, transform.scale))
+	{
+		transform.scale = ReadScale(reader);
+	}
+
+	return transform;
+}
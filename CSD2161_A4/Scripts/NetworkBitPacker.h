@@ -0,0 +1,108 @@
+/******************************************************************************/
+/*!
+\file		NetworkBitPacker.h
+\author
+\par
+\date
+\brief		This file declares the bit level writer and reader used to
+			serialise network data, and the functions to quantise a
+			NetworkTransform to the precision needed by the playfield.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef NETWORK_BIT_PACKER
+#define NETWORK_BIT_PACKER // header guard
+
+#include <cstdint>					// uint32_t
+#include <cstddef>					// size_t
+
+#include "NetworkGameState.h"		// NetworkTransform, ObjectType
+
+// Quantisation ranges. Objects wrap slightly outside the screen, so a margin is kept around it
+#define PLAYFIELD_MARGIN		64.0f
+#define POSITION_MIN_X			(-SCREEN_SIZE_X * 0.5f - PLAYFIELD_MARGIN)
+#define POSITION_MAX_X			( SCREEN_SIZE_X * 0.5f + PLAYFIELD_MARGIN)
+#define POSITION_MIN_Y			(-SCREEN_SIZE_Y * 0.5f - PLAYFIELD_MARGIN)
+#define POSITION_MAX_Y			( SCREEN_SIZE_Y * 0.5f + PLAYFIELD_MARGIN)
+#define POSITION_BITS			13		// ~0.11 units per step over the playfield
+#define VELOCITY_MAX			512.0f
+#define VELOCITY_BITS			14		// ~0.06 units/s per step
+#define ROTATION_BITS			12		// fixed point angle, 4096 steps per turn
+#define SCALE_MAX				128.0f
+#define SCALE_BITS				10		// 0.125 units per step
+#define OBJECT_TYPE_BITS		2		// ObjectType has 4 values
+
+// Writes values using only the given number of bits
+class BitWriter
+{
+public:
+	BitWriter(char* buffer, size_t capacity);
+
+	void WriteBits(uint32_t value, uint32_t bits);
+	void WriteBool(bool value);
+	void WriteFloat(float value);
+
+	// Number of bytes used, rounding the last partial byte up
+	size_t GetBytesWritten() const;
+	size_t GetBitsRemaining() const;
+	bool HasOverflowed() const;
+
+private:
+	uint8_t* _buffer;
+	size_t _capacity;
+	size_t _bitPosition;
+	bool _overflow;
+};
+
+// Reads values written by a BitWriter. Reads past the end return 0 and mark the reader as failed
+class BitReader
+{
+public:
+	BitReader(char const* buffer, size_t size);
+
+	uint32_t ReadBits(uint32_t bits);
+	bool ReadBool();
+	float ReadFloat();
+
+	bool HasOverflowed() const;
+
+private:
+	uint8_t const* _buffer;
+	size_t _size;
+	size_t _bitPosition;
+	bool _overflow;
+};
+
+// Functions to map a float in [min, max] onto an unsigned integer of the given bits and back
+uint32_t QuantizeFloat(float value, float min, float max, uint32_t bits);
+float DequantizeFloat(uint32_t value, float min, float max, uint32_t bits);
+
+// Functions to map an angle in radians onto a fixed point angle of the given bits and back
+uint32_t QuantizeAngle(float angle, uint32_t bits);
+float DequantizeAngle(uint32_t value, uint32_t bits);
+
+// Returns true if the type always has the same scale, which is then not sent
+bool GetFixedScale(ObjectType type, AEVec2& scale);
+
+// Functions to write and read each quantised field of a transform
+void WritePosition(BitWriter& writer, AEVec2 const& position);
+void WriteVelocity(BitWriter& writer, AEVec2 const& velocity);
+void WriteRotation(BitWriter& writer, float rotation);
+void WriteScale(BitWriter& writer, AEVec2 const& scale);
+AEVec2 ReadPosition(BitReader& reader);
+AEVec2 ReadVelocity(BitReader& reader);
+float ReadRotation(BitReader& reader);
+AEVec2 ReadScale(BitReader& reader);
+
+// Function to snap the transform to the values the receiver will decode
+NetworkTransform QuantizeTransform(NetworkTransform const& transform, ObjectType type);
+
+// Functions to write and read a whole transform. The scale is skipped for types with a fixed scale
+void WriteTransform(BitWriter& writer, NetworkTransform const& transform, ObjectType type);
+NetworkTransform ReadTransform(BitReader& reader, ObjectType type);
+
+#endif
@@ -0,0 +1,164 @@
+/******************************************************************************/
+/*!
+\file		NetworkClient.cpp
+\author
+\par
+\date
+\brief		This file contains the client side threads that need the game
+			state manager and the graphics, kept out of Network.cpp so the
+			headless server builds without the Alpha Engine.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#include "Network.h"
+#include "Main.h"		// main headers
+#include "ClientPrediction.h"	// ResetPrediction, ReconcileLocalShip
+#include "SnapshotInterpolation.h"	// ResetInterpolation, PushInterpolationSnapshot
+#include "Logger.h"		// LOG_INFO, LOG_DEBUG
+
+// Thread function to receive packets continuously
+void ListenForUpdates(SOCKET socket, sockaddr_in serverAddr, PlayerData& player)
+{
+	while (true)
+	{
+		NetworkPacket receivedPacket = ReceivePacket(socket, serverAddr);
+		if (receivedPacket.packetID == GAME_STATE_UPDATE)
+		{
+			uint32_t sequenceNumber{};
+			bool complete = false;
+			if (!UnpackGateStateData(receivedPacket, sequenceNumber, complete))
+			{
+				continue; // baseline no longer available, wait for the next snapshot
+			}
+			if (!complete)
+			{
+				continue;
+			}
+			SendGameStateAck(socket, serverAddr, sequenceNumber);
+
+			// Only whole snapshots are drawn and reconciled with, so the local ship is the server's and
+			// not one extrapolated for a lost fragment. One finishing after a newer snapshot started is dropped
+			std::lock_guard<std::mutex> lock(gameDataMutex);
+			if (gameDataState.sequenceNumber != sequenceNumber)
+			{
+				continue;
+			}
+			PushInterpolationSnapshot(gameDataState, GetTimeNow());
+
+			for (int i = 0; i < static_cast<int>(gameDataState.objectCount); ++i)
+			{
+				if (gameDataState.objects[i].type == ObjectType::OBJ_SHIP && gameDataState.objects[i].identifier == clientPort)
+				{
+					// The local ship runs ahead of the server, the snapshot only corrects it
+					ReconcileLocalShip(player, gameDataState.objects[i].transform, gameDataState.inputTick, gameDataState.sequenceNumber);
+					for (int j = 0; j < static_cast<int>(gameDataState.playerCount); ++j)
+					{
+						if (gameDataState.playerData[j].identifier == clientPort)
+						{
+							player.stats = gameDataState.playerData[j];
+						}
+					}
+				}
+			}
+
+        } else if (receivedPacket.packetID == REQUEST_ACCEPTED) {
+
+            LOG_INFO("Joined the lobby successfully!");
+            LOG_INFO("Waiting for lobby to start...");
+
+            gGameStateNext = GS_LOBBY;
+            
+        } else if (receivedPacket.packetID == GAME_STATE_START) {
+
+            uint32_t tickRate{};
+            ReceiveGameStateStart(udpClientSocket, clientData, tickRate, receivedPacket);
+            ResetPrediction(clientData.transform, tickRate);
+            ResetInterpolation();
+            gGameStateNext = GS_ASTEROIDS;
+
+        } else if (receivedPacket.packetID == SEND_CLIENT_COUNT) {
+
+            ReceiveClientCount(receivedPacket);
+        }
+
+		LOG_DEBUG("Pos: " << player.transform.position.x << " " << player.transform.position.y);
+	}
+
+}
+
+void Render()
+{
+    // Initialize the system
+    AESysInit(g_instanceH, g_show, 800, 600, 1, 60, false, NULL);
+
+    pFont = (int)AEGfxCreateFont("Resources/Arial Italic.ttf", fontSize);
+
+    // Changing the window title
+    AESysSetWindowTitle("Asteroids!");
+
+    //set background color
+    AEGfxSetBackgroundColor(0.0f, 0.0f, 0.0f);
+
+    // set starting game state to asteroid
+    //GameStateMgrInit(GS_ASTEROIDS);
+    GameStateMgrInit(GS_MAINMENU);  // Start at the main Menu
+
+    // breaks this loop if game state set to quit
+    while (gGameStateCurr != GS_QUIT)
+    {
+        // reset the system modules
+        AESysReset();
+
+        // If not restarting, load the gamestate
+        if (gGameStateCurr != GS_RESTART)
+        {
+            GameStateMgrUpdate();
+            GameStateLoad();
+        }
+        else
+        {
+            gGameStateNext = gGameStateCurr = gGameStatePrev;
+        }
+
+        // Initialize the gamestate
+        GameStateInit();
+
+        // main game loop
+        while (gGameStateCurr == gGameStateNext) {
+
+            AESysFrameStart(); // start of frame
+
+            GameStateUpdate(); // update current game state
+
+            GameStateDraw(); // draw current game state
+
+            AESysFrameEnd(); // end of frame
+
+            // check if forcing the application to quit
+            if (AESysDoesWindowExist() == false)
+            {
+                gGameStateNext = GS_QUIT;
+            }
+
+            g_dt = static_cast<f32>(AEFrameRateControllerGetFrameTime()); // get delta time
+            g_appTime += g_dt; // accumulate application time
+        }
+
+        GameStateFree(); // free current game state
+
+        // unload current game state unless set to restart
+        if (gGameStateNext != GS_RESTART)
+            GameStateUnload();
+
+        // set prev and curr for the next game states
+        gGameStatePrev = gGameStateCurr;
+        gGameStateCurr = gGameStateNext;
+    }
+
+    // free the system
+    AESysExit();
+}
@@ -0,0 +1,461 @@
+/******************************************************************************/
+/*!
+\file		NetworkConnection.cpp
+\author
+\par
+\date
+\brief		This file contains the definitions of the selective repeat window
+			kept for each remote address, and the list of connections.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "NetworkConnection.h"
+#include "Logger.h"			// LOG_DEBUG, LOG_WARNING
+
+#include <vector>			// std::vector
+#include <algorithm>			// std::min, std::max, std::clamp
+#include <cmath>				// fabsf
+#include <atomic>			// std::atomic
+
+static std::mutex connectionsMutex;
+static std::map<uint64_t, NetworkConnection> connections;	// remote address and port : connection
+static std::atomic<int> readyPacketCount{ 0 };				// ordered packets waiting in any connection
+
+static uint64_t GetConnectionKey(sockaddr_in const& address)
+{
+	return (static_cast<uint64_t>(address.sin_addr.s_addr) << 16) | address.sin_port;
+}
+
+NetworkConnection::NetworkConnection() :
+	_socket{ INVALID_SOCKET },
+	_address{},
+	_nextSeqNum{ SEQ_NUM_MIN },
+	_sendBase{ SEQ_NUM_MIN },
+	_recvBase{ SEQ_NUM_MIN },
+	_newestSequenced{ 0 },
+	_hasSequenced{ false },
+	_smoothedRtt{ 0.0f },
+	_rttVariation{ 0.0f },
+	_rto{ static_cast<float>(TIMEOUT_MS) },
+	_hasRttSample{ false },
+	_retransmitDeadline{ UINT64_MAX },
+	_ackNumber{ ACK_NONE },
+	_ackBits{ 0 },
+	_ackPending{ false },
+	_ackPendingSince{ 0 }
+{
+}
+
+bool NetworkConnection::IsWindowFull() const
+{
+	return (_nextSeqNum + SEQ_NUM_SPACE - _sendBase) % SEQ_NUM_SPACE >= WIND_SIZE;
+}
+
+bool NetworkConnection::IsInSendWindow(uint32_t seqNum) const
+{
+	return (seqNum + SEQ_NUM_SPACE - _sendBase) % SEQ_NUM_SPACE < (_nextSeqNum + SEQ_NUM_SPACE - _sendBase) % SEQ_NUM_SPACE;
+}
+
+void NetworkConnection::Reset()
+{
+	_sendBuffer.Clear();
+	_nextSeqNum = _sendBase;
+	_retransmitDeadline = UINT64_MAX;
+}
+
+bool NetworkConnection::Send(SOCKET socket, sockaddr_in const& address, NetworkPacket packet, Channel channel)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// Only the reliable channels use the window, so stale game states never hold it up
+	bool reliable = channel == Channel::RELIABLE_ORDERED || channel == Channel::RELIABLE_UNORDERED;
+	if (reliable && IsWindowFull())
+	{
+		return false;
+	}
+
+	if (reliable)
+	{
+		LOG_DEBUG("Sending packet of sequence number: " << _nextSeqNum << ", packet id " << packet.packetID
+				  << ", flag " << static_cast<int>(packet.flags));
+
+		packet.seqNumber = _nextSeqNum;
+	}
+	WriteAck(packet);
+
+	if (!SendDatagram(socket, address, packet))
+	{
+		return false;
+	}
+
+	if (reliable)
+	{
+		_nextSeqNum = (_nextSeqNum + 1) % SEQ_NUM_SPACE;
+		_socket = socket;
+		_address = address;
+
+		// Only the header and used payload need to be kept
+		SentPacket& sent = _sendBuffer.Insert(packet.seqNumber);
+		memcpy(static_cast<void*>(&sent.packet), &packet, GetPacketSize(packet));
+		sent.firstSent = sent.lastSent = GetTimeNow();
+		sent.deadline = sent.firstSent + GetRetransmitTimeout(0);
+		sent.retransmits = 0;
+		sent.acked = false;
+		_retransmitDeadline = (std::min)(_retransmitDeadline, sent.deadline);
+	}
+	return true;
+}
+
+bool NetworkConnection::SendAck(SOCKET socket, sockaddr_in const& address, NetworkPacket packet)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return SendAckPacket(socket, address, packet);
+}
+
+bool NetworkConnection::SendAckPacket(SOCKET socket, sockaddr_in const& address, NetworkPacket& packet)
+{
+	// Only the header is needed, and ACKs do not use up a sequence number
+	packet.flags = 1;
+	packet.payloadLength = 0;
+	WriteAck(packet);
+
+	return SendDatagram(socket, address, packet);
+}
+
+void NetworkConnection::WriteAck(NetworkPacket& packet)
+{
+	packet.ackNumber = _ackNumber;
+	packet.ackBits = _ackBits;
+	_ackPending = false;
+}
+
+void NetworkConnection::UpdateRoundTripTime(float sample)
+{
+	if (!_hasRttSample)
+	{
+		_smoothedRtt = sample;
+		_rttVariation = sample * 0.5f;
+		_hasRttSample = true;
+	}
+	else
+	{
+		_rttVariation = (1.0f - RTT_BETA) * _rttVariation + RTT_BETA * fabsf(_smoothedRtt - sample);
+		_smoothedRtt = (1.0f - RTT_ALPHA) * _smoothedRtt + RTT_ALPHA * sample;
+	}
+
+	_rto = std::clamp(_smoothedRtt + (std::max)(1.0f, 4.0f * _rttVariation),
+					  static_cast<float>(RTO_MIN_MS), static_cast<float>(RTO_MAX_MS));
+}
+
+uint64_t NetworkConnection::GetRetransmitTimeout(uint32_t retransmits) const
+{
+	// Back off exponentially while the peer does not answer
+	uint64_t timeout = static_cast<uint64_t>(_rto) << (std::min)(retransmits, 16u);
+	return std::min<uint64_t>(timeout, RTO_MAX_MS);
+}
+
+void NetworkConnection::Acknowledge(uint32_t seqNum, uint64_t now)
+{
+	SentPacket* sent = _sendBuffer.Find(seqNum);
+	if (sent == nullptr || sent->acked || !IsInSendWindow(seqNum))
+	{
+		return;
+	}
+	sent->acked = true;
+
+	// An ACK of a resent packet could belong to any of its copies (Karn's algorithm)
+	if (sent->retransmits == 0)
+	{
+		UpdateRoundTripTime(static_cast<float>(now - sent->firstSent));
+	}
+}
+
+void NetworkConnection::ReadAck(NetworkPacket const& packet)
+{
+	if (packet.ackNumber >= SEQ_NUM_SPACE)
+	{
+		return;
+	}
+
+	uint64_t now = GetTimeNow();
+	Acknowledge(packet.ackNumber, now);
+	for (uint32_t i = 0; i < 32; ++i)
+	{
+		if (packet.ackBits & (1u << i))
+		{
+			Acknowledge((packet.ackNumber + SEQ_NUM_SPACE - 1 - i) % SEQ_NUM_SPACE, now);
+		}
+	}
+
+	// Advance sendBase while the lowest unacknowledged packet is now acknowledged
+	for (SentPacket* base = _sendBuffer.Find(_sendBase); base && base->acked; base = _sendBuffer.Find(_sendBase))
+	{
+		LOG_DEBUG("Sliding window: removing " << _sendBase);
+		_sendBuffer.Remove(_sendBase);
+		_sendBase = (_sendBase + 1) % SEQ_NUM_SPACE;
+	}
+
+	// Deadlines of acknowledged packets are only dropped when Retransmit runs, unless none is left
+	if (_sendBase == _nextSeqNum)
+	{
+		_retransmitDeadline = UINT64_MAX;
+	}
+}
+
+bool NetworkConnection::Receive(SOCKET socket, sockaddr_in const& address, NetworkPacket const& packet)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_socket = socket;
+	_address = address;
+
+	// Every packet carries the peer's acknowledgements of what we sent
+	ReadAck(packet);
+
+	// Standalone ACKs carry nothing else
+	if (packet.flags == 1)
+	{
+		return true;
+	}
+
+	Channel channel = GetPacketChannel(packet.packetID);
+	if (channel == Channel::UNRELIABLE)
+	{
+		return true;
+	}
+	if (channel == Channel::UNRELIABLE_SEQUENCED)
+	{
+		if (_hasSequenced && static_cast<int32_t>(packet.seqNumber - _newestSequenced) < 0)
+		{
+			return false;
+		}
+		_newestSequenced = packet.seqNumber;
+		_hasSequenced = true;
+		return true;
+	}
+
+	uint32_t seqNum = packet.seqNumber % SEQ_NUM_SPACE;
+
+	// Remember the packet for the ACK fields, newer packets shift the older ones into the mask
+	uint32_t ahead = (seqNum + SEQ_NUM_SPACE - _ackNumber) % SEQ_NUM_SPACE;
+	if (_ackNumber == ACK_NONE)
+	{
+		_ackNumber = seqNum;
+		_ackBits = 0;
+	}
+	else if (ahead > 0 && ahead < SEQ_NUM_SPACE / 2)
+	{
+		_ackBits = (_ackBits << ahead) | (1u << (ahead - 1));
+		_ackNumber = seqNum;
+	}
+	else if (ahead != 0)
+	{
+		uint32_t behind = SEQ_NUM_SPACE - ahead;
+		if (behind <= 32)
+		{
+			_ackBits |= 1u << (behind - 1);
+		}
+	}
+
+	// Duplicates are acknowledged again, in case the first ACK was lost
+	if (!_ackPending)
+	{
+		_ackPending = true;
+		_ackPendingSince = GetTimeNow();
+	}
+
+	// Packets behind the window were already handed out, resends of them are dropped
+	if (!((seqNum >= _recvBase && seqNum < _recvBase + WIND_SIZE) ||
+		  (seqNum < _recvBase && (seqNum + SEQ_NUM_SPACE) < (_recvBase + WIND_SIZE))) ||
+		_recvBuffer.Exists(seqNum))
+	{
+		// The client waits for an ACK of REQ_CONNECT itself, the delayed ACK does not name the packet
+		if (packet.packetID == REQ_CONNECT)
+		{
+			NetworkPacket ack = packet;
+			SendAckPacket(socket, address, ack);
+		}
+		return false;
+	}
+
+	LOG_DEBUG("Received packet of sequence number: " << seqNum << ", packet id " << packet.packetID
+			  << ", flag " << static_cast<int>(packet.flags));
+
+	// Unordered packets, and ordered ones with nothing missing before them, are handed out now
+	bool deliver = channel == Channel::RELIABLE_UNORDERED || seqNum == _recvBase;
+
+	ReceivedPacket& received = _recvBuffer.Insert(seqNum);
+	received.delivered = deliver;
+	if (!deliver)
+	{
+		memcpy(static_cast<void*>(&received.packet), &packet, GetPacketSize(packet));
+	}
+
+	// Slide window forward when contiguous packets are received, releasing the ordered ones held back
+	for (ReceivedPacket* base = _recvBuffer.Find(_recvBase); base; base = _recvBuffer.Find(_recvBase))
+	{
+		if (!base->delivered)
+		{
+			_ready.push(base->packet);
+			++readyPacketCount;
+		}
+		_recvBuffer.Remove(_recvBase);
+		_recvBase = (_recvBase + 1) % SEQ_NUM_SPACE;
+	}
+	return deliver;
+}
+
+bool NetworkConnection::PopReady(NetworkPacket& packet, sockaddr_in& address)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (_ready.empty())
+	{
+		return false;
+	}
+
+	packet = _ready.front();
+	address = _address;
+	_ready.pop();
+	--readyPacketCount;
+	return true;
+}
+
+void NetworkConnection::Retransmit(uint64_t now)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// Nothing is due yet, which is the case for almost every call
+	if (now < _retransmitDeadline)
+	{
+		return;
+	}
+
+	// Only the packets inside the send window can be waiting for an ACK
+	uint64_t nextDeadline = UINT64_MAX;
+	for (uint32_t seqNum = _sendBase; seqNum != _nextSeqNum; seqNum = (seqNum + 1) % SEQ_NUM_SPACE)
+	{
+		SentPacket* sent = _sendBuffer.Find(seqNum);
+		if (sent == nullptr || sent->acked)
+		{
+			continue;
+		}
+
+		if (now - sent->firstSent >= TIMEOUT_MS_MAX)
+		{
+			// Receiver is unresponsive
+			LOG_WARNING("Receiver unresponsive. Resetting connection.");
+			Reset();
+			return;
+		}
+
+		if (now >= sent->deadline)
+		{
+			WriteAck(sent->packet);
+			SendDatagram(_socket, _address, sent->packet);
+			++sent->retransmits;
+			sent->lastSent = now;  // Update retransmission time
+			sent->deadline = now + GetRetransmitTimeout(sent->retransmits);
+		}
+		nextDeadline = (std::min)(nextDeadline, sent->deadline);
+	}
+	_retransmitDeadline = nextDeadline;
+}
+
+void NetworkConnection::FlushAck(uint64_t now)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (!_ackPending || now - _ackPendingSince < ACK_DELAY_MS)
+	{
+		return;
+	}
+
+	NetworkPacket packet;
+	packet.seqNumber = _nextSeqNum;
+	packet.packetID = UINT16_MAX;		// not a reply to any packet, ignored by the handlers
+	SendAckPacket(_socket, _address, packet);
+}
+
+uint64_t NetworkConnection::GetNextDeadline()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	uint64_t ackDeadline = _ackPending ? _ackPendingSince + ACK_DELAY_MS : UINT64_MAX;
+	return (std::min)(_retransmitDeadline, ackDeadline);
+}
+
+NetworkConnection& GetConnection(sockaddr_in const& address)
+{
+	std::lock_guard<std::mutex> lock(connectionsMutex);
+	return connections[GetConnectionKey(address)];
+}
+
+bool PopReadyPacket(NetworkPacket& packet, sockaddr_in& address)
+{
+	// Nothing is held back almost all the time, so the list is not even locked
+	if (readyPacketCount.load() == 0)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(connectionsMutex);
+	for (auto& [key, connection] : connections)
+	{
+		if (connection.PopReady(packet, address))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool HasReadyPackets()
+{
+	return readyPacketCount.load() > 0;
+}
+
+uint64_t GetNextConnectionDeadline()
+{
+	std::vector<NetworkConnection*> list;
+	{
+		std::lock_guard<std::mutex> lock(connectionsMutex);
+		list.reserve(connections.size());
+		for (auto& [key, connection] : connections)
+		{
+			list.push_back(&connection);
+		}
+	}
+
+	uint64_t deadline = UINT64_MAX;
+	for (NetworkConnection* connection : list)
+	{
+		deadline = (std::min)(deadline, connection->GetNextDeadline());
+	}
+	return deadline;
+}
+
+void UpdateConnections(uint64_t now)
+{
+	// Only the list is locked here, each connection locks itself while it is updated
+	std::vector<NetworkConnection*> list;
+	{
+		std::lock_guard<std::mutex> lock(connectionsMutex);
+		list.reserve(connections.size());
+		for (auto& [key, connection] : connections)
+		{
+			list.push_back(&connection);
+		}
+	}
+
+	for (NetworkConnection* connection : list)
+	{
+		connection->Retransmit(now);
+		connection->FlushAck(now);
+	}
+}
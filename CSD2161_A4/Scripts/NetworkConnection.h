@@ -0,0 +1,137 @@
+/******************************************************************************/
+/*!
+\file		NetworkConnection.h
+\author
+\par
+\date
+\brief		This file declares the connection kept for each remote address,
+			which owns the selective repeat window used by the reliable
+			channels and the sequencing of the unreliable ones.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef NETWORK_CONNECTION
+#define NETWORK_CONNECTION // header guard
+
+#include "Network.h"		// NetworkPacket, SOCKET, sockaddr_in
+#include "SequenceBuffer.h"	// SequenceBuffer
+
+#include <queue>			// std::queue
+
+// Reliable packet kept until the peer acknowledges it
+struct SentPacket
+{
+	NetworkPacket packet;
+	uint64_t firstSent = 0;		// time of the first transmission
+	uint64_t lastSent = 0;		// time of the last transmission
+	uint64_t deadline = 0;		// time it is resent if still not acknowledged
+	uint32_t retransmits = 0;	// each one doubles the timeout
+	bool acked = false;
+};
+
+// Reliable packet received ahead of recvBase. Ordered packets wait here until the gap is filled
+struct ReceivedPacket
+{
+	NetworkPacket packet;
+	bool delivered = false;		// unordered packets are handed out on arrival
+};
+
+// Selective repeat state for one peer. Every method locks the connection, so a connection can be
+// used from several threads without blocking the other connections
+class NetworkConnection
+{
+public:
+	NetworkConnection();
+
+	// Sends the packet on the channel. Reliable packets take the next sequence number and are kept
+	// until acknowledged, unreliable sequenced packets keep the sequence number set by the caller
+	// so several packets can share one. Returns false if the window is full or the send failed
+	bool Send(SOCKET socket, sockaddr_in const& address, NetworkPacket packet, Channel channel);
+
+	// Sends the header of the packet as a standalone ACK, carrying every pending acknowledgement
+	bool SendAck(SOCKET socket, sockaddr_in const& address, NetworkPacket packet);
+
+	// Updates the windows with a packet received from the peer, including the ACKs in its header
+	// Returns false if the packet must not be handed out: a duplicate, an out of date sequenced
+	// packet, or an ordered packet waiting for an earlier one
+	bool Receive(SOCKET socket, sockaddr_in const& address, NetworkPacket const& packet);
+
+	// Takes the next ordered packet that was waiting for a gap to be filled
+	bool PopReady(NetworkPacket& packet, sockaddr_in& address);
+
+	// Resends the packets that timed out. The window is reset if the peer stopped answering
+	void Retransmit(uint64_t now);
+
+	// Sends a standalone ACK if nothing was sent to carry the pending ones for ACK_DELAY_MS
+	void FlushAck(uint64_t now);
+
+	// Returns the earliest time Retransmit or FlushAck may have something to do, UINT64_MAX if none
+	// It can be early if packets were acknowledged since the last Retransmit, never late
+	uint64_t GetNextDeadline();
+
+private:
+	bool IsWindowFull() const;
+	bool IsInSendWindow(uint32_t seqNum) const;
+	void Reset();
+
+	bool SendAckPacket(SOCKET socket, sockaddr_in const& address, NetworkPacket& packet);
+	void WriteAck(NetworkPacket& packet);
+	void ReadAck(NetworkPacket const& packet);
+	void Acknowledge(uint32_t seqNum, uint64_t now);
+
+	// Round trip time estimation, samples only come from packets that were never resent
+	void UpdateRoundTripTime(float sample);
+	uint64_t GetRetransmitTimeout(uint32_t retransmits) const;
+
+	std::mutex _mutex;
+
+	SOCKET _socket;									// socket last used with the peer
+	sockaddr_in _address;							// address of the peer
+
+	uint32_t _nextSeqNum;
+	uint32_t _sendBase;
+	uint32_t _recvBase;
+
+	// Slots are reused as the windows slide, so sending and acknowledging never allocate
+	SequenceBuffer<SentPacket, WIND_SIZE> _sendBuffer;			// packets awaiting ACK
+	SequenceBuffer<ReceivedPacket, WIND_SIZE> _recvBuffer;		// packets received ahead of recvBase
+	std::queue<NetworkPacket> _ready;							// ordered packets released by the window
+
+	uint32_t _newestSequenced;						// newest unreliable sequenced packet received
+	bool _hasSequenced;
+
+	// Retransmission timeout, measured from the ACKs of the peer
+	float _smoothedRtt;								// milliseconds
+	float _rttVariation;							// milliseconds
+	float _rto;										// milliseconds, before backing off
+	bool _hasRttSample;
+	uint64_t _retransmitDeadline;					// earliest deadline of the packets awaiting ACK
+
+	// Acknowledgements written into the header of every packet sent to the peer
+	uint32_t _ackNumber;							// latest sequence number received
+	uint32_t _ackBits;								// packets received before it
+	bool _ackPending;								// received packets not acknowledged yet
+	uint64_t _ackPendingSince;
+};
+
+// Function to get the connection of the remote address, creating it on first use
+// Connections are never removed, so the reference stays valid
+NetworkConnection& GetConnection(sockaddr_in const& address);
+
+// Function to take an ordered packet of any connection that was waiting for a gap to be filled
+bool PopReadyPacket(NetworkPacket& packet, sockaddr_in& address);
+
+// Function to check if any connection has an ordered packet waiting to be taken
+bool HasReadyPackets();
+
+// Function to get the earliest time UpdateConnections may have something to do, UINT64_MAX if none
+uint64_t GetNextConnectionDeadline();
+
+// Function to resend the timed out packets and the delayed ACKs of every connection
+void UpdateConnections(uint64_t now);
+
+#endif
@@ -0,0 +1,124 @@
+/******************************************************************************/
+/*!
+\file		NetworkEventLoop.cpp
+\author
+\par
+\date
+\brief		This file contains the definitions of the wait of the server
+			thread for a packet or for its next deadline.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "NetworkEventLoop.h"
+
+#include "NetworkConnection.h"	// HasReadyPackets
+#include "NetworkBatch.h"		// HasBufferedDatagrams
+
+#ifdef __linux__
+
+#include <sys/epoll.h>			// epoll_create1, epoll_ctl, epoll_wait
+#include <sys/timerfd.h>		// timerfd_create, timerfd_settime
+
+NetworkEventLoop::NetworkEventLoop(SOCKET socket) :
+	_socket{ socket },
+	_epoll{ epoll_create1(EPOLL_CLOEXEC) },
+	_timer{ timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC) }
+{
+	epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.fd = _socket;
+	epoll_ctl(_epoll, EPOLL_CTL_ADD, _socket, &event);
+
+	event.data.fd = _timer;
+	epoll_ctl(_epoll, EPOLL_CTL_ADD, _timer, &event);
+}
+
+NetworkEventLoop::~NetworkEventLoop()
+{
+	close(_timer);
+	close(_epoll);
+}
+
+bool NetworkEventLoop::Wait(uint64_t deadline)
+{
+	if (HasBufferedDatagrams() || HasReadyPackets())
+		return true;
+
+	uint64_t now = GetTimeNow();
+	if (deadline <= now)
+		return false;
+
+	// GetTimeNow uses the steady clock, which is CLOCK_MONOTONIC, so the deadline is set as is
+	// A zeroed itimerspec disarms the timer when only packets are waited for
+	itimerspec expiry{};
+	if (deadline != UINT64_MAX)
+	{
+		expiry.it_value.tv_sec = static_cast<time_t>(deadline / 1000);
+		expiry.it_value.tv_nsec = static_cast<long>(deadline % 1000) * 1000000;
+	}
+	timerfd_settime(_timer, TFD_TIMER_ABSTIME, &expiry, nullptr);
+
+	epoll_event events[2];
+	int count = epoll_wait(_epoll, events, 2, -1);
+
+	bool readable = false;
+	for (int i = 0; i < count; ++i)
+	{
+		if (events[i].data.fd == _socket)
+		{
+			readable = true;
+		}
+		else
+		{
+			// Clears the expiry so the timer stops being reported
+			uint64_t expirations;
+			read(_timer, &expirations, sizeof(expirations));
+		}
+	}
+	return readable;
+}
+
+#else
+
+NetworkEventLoop::NetworkEventLoop(SOCKET socket) :
+	_socket{ socket }
+{
+}
+
+NetworkEventLoop::~NetworkEventLoop()
+{
+}
+
+bool NetworkEventLoop::Wait(uint64_t deadline)
+{
+	if (HasBufferedDatagrams() || HasReadyPackets())
+		return true;
+
+	uint64_t now = GetTimeNow();
+	if (deadline <= now)
+		return false;
+
+	fd_set readSet;
+	FD_ZERO(&readSet);
+	FD_SET(_socket, &readSet);
+
+	// select has no absolute timeout, so the wait is measured from now
+	timeval timeout{};
+	timeval* timeoutPointer = nullptr;
+	if (deadline != UINT64_MAX)
+	{
+		uint64_t wait = deadline - now;
+		timeout.tv_sec = static_cast<long>(wait / 1000);
+		timeout.tv_usec = static_cast<long>(wait % 1000) * 1000;
+		timeoutPointer = &timeout;
+	}
+
+	return select(static_cast<int>(_socket) + 1, &readSet, nullptr, nullptr, timeoutPointer) > 0;
+}
+
+#endif
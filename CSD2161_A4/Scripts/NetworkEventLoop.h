@@ -0,0 +1,47 @@
+/******************************************************************************/
+/*!
+\file		NetworkEventLoop.h
+\author
+\par
+\date
+\brief		This file declares the wait of the server thread for a packet
+			or for its next deadline. epoll and a timerfd are used on Linux,
+			select elsewhere.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef NETWORK_EVENT_LOOP
+#define NETWORK_EVENT_LOOP // header guard
+
+#include "Network.h"		// SOCKET
+
+// Waits on one socket. Deadlines are times from GetTimeNow, so ticks do not drift with the time
+// spent handling the packets
+class NetworkEventLoop
+{
+public:
+	NetworkEventLoop(SOCKET socket);
+	~NetworkEventLoop();
+
+	// Blocks until a packet can be received or the deadline is reached, UINT64_MAX waits for a
+	// packet only. Returns true if a packet can be received without blocking, including packets
+	// already read by this thread or held back by a connection
+	bool Wait(uint64_t deadline);
+
+	NetworkEventLoop(const NetworkEventLoop&) = delete;
+	NetworkEventLoop& operator=(const NetworkEventLoop&) = delete;
+
+private:
+	SOCKET _socket;
+
+#ifdef __linux__
+	int _epoll;			// waits on the socket and the timer together
+	int _timer;			// expires at the deadline
+#endif
+};
+
+#endif
@@ -15,6 +15,7 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 
 // Main header
 #include "NetworkGameState.h"
+#include "Platform.h"					// strncpy_s
 
 // definition for networked game state
 // std::mutex gameStateMutex;
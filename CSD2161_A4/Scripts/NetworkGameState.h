@@ -18,7 +18,7 @@ prior written consent of DigiPen Institute of Technology is prohibited.
 #define NETWORK_GAME_STATE // header guard
 
 #include <iostream>					// std::cout, uint32_t
-#include <AEEngine.h>				// AEVec2
+#include <AEVec2.h>					// AEVec2
 #include <vector>					// std::vector
 #include <mutex>					// std::mutex
 #include <algorithm>				// std::sort
@@ -78,14 +78,15 @@ struct NetworkLeaderboard
 	NetworkScore scores[MAX_LEADERBOARD_SCORES];
 };
 
-// NOTE: 44 is the maximum number of networks objects that fit one UDP pakcet
-#define MAX_NETWORK_OBJECTS		40		// maximum number of objects
+// NOTE: snapshots are split into several datagrams, so this is not limited by the packet size
+#define MAX_NETWORK_OBJECTS		1024	// maximum number of objects
 #define MAX_PLAYERS				4		// maximum number of players in a lobby
 
 // Main game state, including both player data and objects in the game world
 struct NetworkGameState
 {
 	uint32_t sequenceNumber{};
+	uint32_t inputTick{};			// newest input of the receiving client included, the client replays the later ones
 
 	uint32_t playerCount{};
 	NetworkPlayerData playerData[MAX_PLAYERS];
@@ -95,7 +96,7 @@ struct NetworkGameState
 };
 #pragma pack()
 
-void Render(NetworkGameState& gameState);
+void Render();
 
 // Network game states (To be passed via UDP)
 //extern std::mutex gameStateMutex;
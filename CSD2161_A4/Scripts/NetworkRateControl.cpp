@@ -0,0 +1,158 @@
+/******************************************************************************/
+/*!
+\file		NetworkRateControl.cpp
+\author
+\par
+\date
+\brief		This file contains the definitions of the control of the rate
+			snapshots are sent to one client at.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "NetworkRateControl.h"
+
+#include "NetworkSnapshot.h"		// SNAPSHOT_INTERVAL_MS
+#include <algorithm>				// std::max, std::clamp
+#include <cmath>					// std::lround
+
+SnapshotRateControl::SnapshotRateControl() :
+	_minInterval{ 1 },
+	_interval{ 1 },
+	_lastSent{ 0 },
+	_hasSent{ false },
+	_oldestPending{ 0 },
+	_windowStart{ 0 },
+	_windowSent{ 0 },
+	_windowAcked{ 0 },
+	_windowSentBytes{ 0 },
+	_windowAckedBytes{ 0 },
+	_loss{ 0.0f },
+	_bandwidth{ 0 }
+{
+}
+
+void SnapshotRateControl::Reset(uint32_t maxRate, uint64_t now)
+{
+	long interval = std::lround(1000.0f / ((std::max)(maxRate, 1u) * SNAPSHOT_INTERVAL_MS));
+	_minInterval = static_cast<uint32_t>(std::clamp<long>(interval, 1, SNAPSHOT_MAX_INTERVAL));
+	_interval = _minInterval;
+	_hasSent = false;
+	_history.Clear();
+	_windowStart = now;
+	_windowSent = _windowAcked = _windowSentBytes = _windowAckedBytes = 0;
+	_loss = 0.0f;
+	_bandwidth = 0;
+}
+
+bool SnapshotRateControl::IsSendDue(uint32_t sequence) const
+{
+	return !_hasSent || sequence - _lastSent >= _interval;
+}
+
+void SnapshotRateControl::OnSent(uint32_t sequence, size_t bytes, uint64_t now)
+{
+	if (!_hasSent)
+	{
+		_oldestPending = sequence;
+	}
+	_lastSent = sequence;
+	_hasSent = true;
+
+	SentSnapshot& sent = _history.Insert(sequence);
+	sent.sentTime = now;
+	sent.bytes = static_cast<uint32_t>(bytes);
+	sent.acked = false;
+}
+
+void SnapshotRateControl::OnAcked(uint32_t sequence)
+{
+	// ACKs arriving after the timeout find nothing, the snapshot was already counted as lost
+	SentSnapshot* sent = _history.Find(sequence);
+	if (sent)
+	{
+		sent->acked = true;
+	}
+}
+
+bool SnapshotRateControl::Update(uint64_t now)
+{
+	if (!_hasSent)
+		return false;
+
+	// Snapshots no longer remembered cannot be counted
+	if (_lastSent - _oldestPending >= SNAPSHOT_RATE_HISTORY)
+		_oldestPending = _lastSent - SNAPSHOT_RATE_HISTORY + 1;
+
+	// Count in order, up to the first snapshot that can still be acknowledged
+	for (; static_cast<int32_t>(_lastSent - _oldestPending) >= 0; ++_oldestPending)
+	{
+		SentSnapshot* sent = _history.Find(_oldestPending);
+		if (sent == nullptr)
+			continue;		// skipped for this client
+		if (!sent->acked && now < sent->sentTime + SNAPSHOT_ACK_TIMEOUT_MS)
+			break;
+
+		++_windowSent;
+		_windowSentBytes += sent->bytes;
+		if (sent->acked)
+		{
+			++_windowAcked;
+			_windowAckedBytes += sent->bytes;
+		}
+		_history.Remove(_oldestPending);
+	}
+
+	uint64_t elapsed = now - _windowStart;
+	if (elapsed < SNAPSHOT_RATE_WINDOW_MS)
+		return false;
+
+	uint32_t interval = _interval;
+	if (_windowSent > 0)
+	{
+		_loss = 1.0f - static_cast<float>(_windowAcked) / _windowSent;
+		_bandwidth = static_cast<uint32_t>(_windowAckedBytes * 1000ull / elapsed);
+
+		if (_loss > SNAPSHOT_LOSS_HIGH)
+		{
+			// Halve the rate, or lower it to what the client received if that is less
+			uint64_t snapshotBytes = _windowSentBytes / _windowSent;
+			uint64_t perSecond = 1000 / SNAPSHOT_INTERVAL_MS;
+			uint32_t fitting = _bandwidth > 0
+				? static_cast<uint32_t>((snapshotBytes * perSecond + _bandwidth - 1) / _bandwidth)
+				: SNAPSHOT_MAX_INTERVAL;
+			interval = (std::max)(_interval * 2, fitting);
+		}
+		else if (_loss < SNAPSHOT_LOSS_LOW)
+		{
+			interval = _interval - 1;
+		}
+		interval = std::clamp<uint32_t>(interval, _minInterval, SNAPSHOT_MAX_INTERVAL);
+	}
+
+	_windowStart = now;
+	_windowSent = _windowAcked = _windowSentBytes = _windowAckedBytes = 0;
+
+	bool changed = interval != _interval;
+	_interval = interval;
+	return changed;
+}
+
+uint32_t SnapshotRateControl::GetRate() const
+{
+	return 1000 / (_interval * SNAPSHOT_INTERVAL_MS);
+}
+
+float SnapshotRateControl::GetLoss() const
+{
+	return _loss;
+}
+
+uint32_t SnapshotRateControl::GetBandwidth() const
+{
+	return _bandwidth;
+}
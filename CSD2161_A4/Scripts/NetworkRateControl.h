@@ -0,0 +1,87 @@
+/******************************************************************************/
+/*!
+\file		NetworkRateControl.h
+\author
+\par
+\date
+\brief		This file declares the control of the rate snapshots are sent to
+			one client at. The rate backs off when the client stops receiving
+			whole snapshots, and climbs back while they all arrive.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef NETWORK_RATE_CONTROL
+#define NETWORK_RATE_CONTROL // header guard
+
+#include <cstdint>					// uint32_t, uint64_t
+#include <cstddef>					// size_t
+
+#include "SequenceBuffer.h"			// SequenceBuffer
+
+// Snapshots are taken every SNAPSHOT_INTERVAL_MS, a client is sent one every interval of them
+#define SNAPSHOT_DEFAULT_RATE		60			// snapshots per second on a good link, see snapshotRate in the configuration
+#define SNAPSHOT_MAX_INTERVAL		6			// snapshots skipped at most, ~10 per second
+#define SNAPSHOT_RATE_WINDOW_MS		1000		// period loss and bandwidth are measured over
+#define SNAPSHOT_ACK_TIMEOUT_MS		500			// a snapshot not acknowledged by then counts as lost
+#define SNAPSHOT_LOSS_HIGH			0.10f		// loss above which the rate is halved
+#define SNAPSHOT_LOSS_LOW			0.02f		// loss below which the rate climbs back one step
+#define SNAPSHOT_RATE_HISTORY		64			// snapshots remembered until they are acknowledged or time out
+
+// Snapshot sent to the client, waiting to be acknowledged or to time out
+struct SentSnapshot
+{
+	uint64_t sentTime = 0;
+	uint32_t bytes = 0;				// bytes of every fragment, headers included
+	bool acked = false;
+};
+
+class SnapshotRateControl
+{
+public:
+	SnapshotRateControl();
+
+	// Starts over at the configured rate, which the rate never goes above
+	void Reset(uint32_t maxRate, uint64_t now);
+
+	// Returns true if the snapshot with the sequence number should be sent to the client
+	bool IsSendDue(uint32_t sequence) const;
+
+	void OnSent(uint32_t sequence, size_t bytes, uint64_t now);
+	void OnAcked(uint32_t sequence);
+
+	// Counts the snapshots that were acknowledged or timed out, and adjusts the rate once a window
+	// is over. Returns true if the rate changed
+	bool Update(uint64_t now);
+
+	// Snapshots per second sent to the client
+	uint32_t GetRate() const;
+
+	float GetLoss() const;
+	uint32_t GetBandwidth() const;	// bytes per second the client acknowledged
+
+private:
+	uint32_t _minInterval;			// interval of the configured rate
+	uint32_t _interval;				// snapshots taken for each one sent
+	uint32_t _lastSent;				// sequence number of the last snapshot sent
+	bool _hasSent;
+
+	SequenceBuffer<SentSnapshot, SNAPSHOT_RATE_HISTORY> _history;
+	uint32_t _oldestPending;		// oldest sequence number not counted yet
+
+	// Measures of the current window
+	uint64_t _windowStart;
+	uint32_t _windowSent;
+	uint32_t _windowAcked;
+	uint32_t _windowSentBytes;
+	uint32_t _windowAckedBytes;
+
+	// Measures of the last window
+	float _loss;
+	uint32_t _bandwidth;
+};
+
+#endif
@@ -0,0 +1,451 @@
+/******************************************************************************/
+/*!
+\file		NetworkSnapshot.cpp
+\author
+\par
+\date
+\brief		This file contains the definitions of functions to delta encode
+			and decode the networked game state. Only the fields that changed
+			since the baseline are sent, and positions that follow the
+			baseline velocity are predicted instead of being resent. Each
+			snapshot is split into fragments that can be decoded on their
+			own, with the most important objects in the first ones.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "NetworkSnapshot.h"
+#include "NetworkBitPacker.h"		// BitWriter, BitReader
+
+#include <cmath>					// fabsf
+#include <algorithm>				// std::copy, std::stable_sort
+
+// Bits marking which fields of a NetworkObject are present in the delta
+enum ObjectDeltaField : uint8_t
+{
+	OBJECT_TYPE			= 1 << 0,
+	OBJECT_IDENTIFIER	= 1 << 1,
+	OBJECT_POSITION		= 1 << 2,
+	OBJECT_VELOCITY		= 1 << 3,
+	OBJECT_ROTATION		= 1 << 4,
+	OBJECT_SCALE		= 1 << 5,
+	OBJECT_ALL			= 0x3F,
+	OBJECT_MASK_BITS	= 6
+};
+
+// Bits marking which fields of a NetworkPlayerData are present in the delta
+enum PlayerDeltaField : uint8_t
+{
+	PLAYER_IDENTIFIER	= 1 << 0,
+	PLAYER_SCORE		= 1 << 1,
+	PLAYER_LIVES		= 1 << 2,
+	PLAYER_ALL			= 0x07,
+	PLAYER_MASK_BITS	= 3
+};
+
+#define PLAYER_COUNT_BITS		3
+#define OBJECT_COUNT_BITS		16
+#define OBJECT_INDEX_BITS		16
+#define FRAGMENT_INDEX_BITS		8
+#define FRAGMENT_COUNT_OFFSET	8		// byte holding the fragment count, right after both sequence numbers
+
+// Largest object entry: continue bit, index, mask and every field
+#define MAX_OBJECT_ENTRY_BITS	(1 + OBJECT_INDEX_BITS + OBJECT_MASK_BITS + OBJECT_TYPE_BITS + 16 + \
+								 2 * POSITION_BITS + 2 * VELOCITY_BITS + ROTATION_BITS + 2 * SCALE_BITS)
+
+// Priority of each object type, lower is sent first. Distance to the player orders objects of a type
+#define PRIORITY_TYPE_WEIGHT	1.0e7f	// larger than any squared distance on the playfield
+
+void SnapshotBuffer::Store(NetworkGameState const& snapshot)
+{
+	CopyGameState(snapshots.Insert(snapshot.sequenceNumber), snapshot);
+}
+
+NetworkGameState const* SnapshotBuffer::Find(uint32_t sequenceNumber) const
+{
+	return snapshots.Find(sequenceNumber);
+}
+
+void SnapshotBuffer::Clear()
+{
+	snapshots.Clear();
+}
+
+bool SnapshotAssembly::IsComplete() const
+{
+	return active && receivedFragments == (1u << fragmentCount) - 1;
+}
+
+void CopyGameState(NetworkGameState& destination, NetworkGameState const& source)
+{
+	destination.sequenceNumber = source.sequenceNumber;
+	destination.inputTick = source.inputTick;
+	destination.playerCount = source.playerCount;
+	destination.objectCount = source.objectCount;
+	std::copy(source.playerData, source.playerData + source.playerCount, destination.playerData);
+	std::copy(source.objects, source.objects + source.objectCount, destination.objects);
+}
+
+// Position the object reaches if it keeps the baseline velocity for the given number of snapshots
+static AEVec2 PredictPosition(NetworkTransform const& baseline, uint32_t ticks)
+{
+	float elapsed = static_cast<float>(ticks) * SNAPSHOT_INTERVAL_MS / 1000.0f;
+	return AEVec2{ baseline.position.x + baseline.velocity.x * elapsed,
+				   baseline.position.y + baseline.velocity.y * elapsed };
+}
+
+// Applies the fields in the mask onto the baseline object. Shared by the writer and the reader so
+// that both sides reconstruct exactly the same state
+static void ApplyObjectDelta(NetworkObject& object, NetworkObject const& delta, uint8_t mask, uint32_t ticks)
+{
+	AEVec2 predicted = PredictPosition(object.transform, ticks);
+
+	if (mask & OBJECT_TYPE)			object.type = delta.type;
+	if (mask & OBJECT_IDENTIFIER)	object.identifier = delta.identifier;
+	if (mask & OBJECT_VELOCITY)		object.transform.velocity = delta.transform.velocity;
+	if (mask & OBJECT_ROTATION)		object.transform.rotation = delta.transform.rotation;
+	if (mask & OBJECT_SCALE)		object.transform.scale = delta.transform.scale;
+
+	object.transform.position = (mask & OBJECT_POSITION) ? delta.transform.position : predicted;
+
+	// Ships, bullets and walls never send their scale
+	GetFixedScale(object.type, object.transform.scale);
+}
+
+// Fields that must be sent for an object the receiver has no baseline for
+static uint8_t GetFullObjectMask(ObjectType type)
+{
+	AEVec2 fixedScale;
+	return GetFixedScale(type, fixedScale) ? static_cast<uint8_t>(OBJECT_ALL & ~OBJECT_SCALE) : static_cast<uint8_t>(OBJECT_ALL);
+}
+
+static void ApplyPlayerDelta(NetworkPlayerData& player, NetworkPlayerData const& delta, uint8_t mask)
+{
+	if (mask & PLAYER_IDENTIFIER)	player.identifier = delta.identifier;
+	if (mask & PLAYER_SCORE)		player.score = delta.score;
+	if (mask & PLAYER_LIVES)		player.lives = delta.lives;
+}
+
+// The object is expected to be quantised already, so unchanged fields compare equal to the baseline
+static uint8_t GetObjectDeltaMask(NetworkObject const& object, NetworkObject const& baseline, uint32_t ticks)
+{
+	uint8_t mask = 0;
+	AEVec2 predicted = PredictPosition(baseline.transform, ticks);
+	AEVec2 fixedScale;
+
+	if (object.type != baseline.type)								mask |= OBJECT_TYPE;
+	if (object.identifier != baseline.identifier)					mask |= OBJECT_IDENTIFIER;
+	if (object.transform.velocity.x != baseline.transform.velocity.x ||
+		object.transform.velocity.y != baseline.transform.velocity.y)	mask |= OBJECT_VELOCITY;
+	if (object.transform.rotation != baseline.transform.rotation)	mask |= OBJECT_ROTATION;
+	if ((object.transform.scale.x != baseline.transform.scale.x ||
+		 object.transform.scale.y != baseline.transform.scale.y) &&
+		!GetFixedScale(object.type, fixedScale))						mask |= OBJECT_SCALE;
+	if (fabsf(object.transform.position.x - predicted.x) > SNAPSHOT_POSITION_ERROR ||
+		fabsf(object.transform.position.y - predicted.y) > SNAPSHOT_POSITION_ERROR)	mask |= OBJECT_POSITION;
+
+	return mask;
+}
+
+static uint8_t GetPlayerDeltaMask(NetworkPlayerData const& player, NetworkPlayerData const& baseline)
+{
+	uint8_t mask = 0;
+
+	if (player.identifier != baseline.identifier)	mask |= PLAYER_IDENTIFIER;
+	if (player.score != baseline.score)				mask |= PLAYER_SCORE;
+	if (player.lives != baseline.lives)				mask |= PLAYER_LIVES;
+
+	return mask;
+}
+
+// Starts the snapshot from the baseline with every object predicted forward, which is what the
+// receiver holds for any object whose fragment has not arrived or that was left out
+static void BeginSnapshot(NetworkGameState& state, NetworkGameState const* baseline, uint32_t sequenceNumber,
+						  uint32_t playerCount, uint32_t objectCount)
+{
+	uint32_t ticks = baseline ? sequenceNumber - baseline->sequenceNumber : 0;
+
+	state.sequenceNumber = sequenceNumber;
+	state.inputTick = 0;
+	state.playerCount = playerCount;
+	state.objectCount = objectCount;
+
+	for (uint32_t i = 0; i < playerCount; ++i)
+	{
+		state.playerData[i] = (baseline && i < baseline->playerCount) ? baseline->playerData[i] : NetworkPlayerData{};
+	}
+
+	for (uint32_t i = 0; i < objectCount; ++i)
+	{
+		NetworkObject& object = state.objects[i];
+		if (baseline && i < baseline->objectCount)
+		{
+			object = baseline->objects[i];
+			ApplyObjectDelta(object, object, 0, ticks);
+		}
+		else
+		{
+			object = NetworkObject{};	// zero scale, not drawn until its fragment arrives
+		}
+	}
+}
+
+static void WriteFragmentHeader(BitWriter& writer, NetworkGameState const& state, uint32_t baselineSequence, uint32_t fragmentIndex)
+{
+	writer.WriteBits(state.sequenceNumber, 32);
+	writer.WriteBits(baselineSequence, 32);
+	writer.WriteBits(0, FRAGMENT_INDEX_BITS);			// fragment count, filled in once every fragment is written
+	writer.WriteBits(fragmentIndex, FRAGMENT_INDEX_BITS);
+	writer.WriteBits(state.playerCount, PLAYER_COUNT_BITS);
+	writer.WriteBits(state.objectCount, OBJECT_COUNT_BITS);
+	writer.WriteBits(state.inputTick, 32);
+}
+
+void GetSnapshotPriorityOrder(NetworkGameState const& state, uint16_t identifier, uint16_t* order)
+{
+	// Distances are measured from the player's own ship
+	AEVec2 centre{};
+	for (uint32_t i = 0; i < state.objectCount; ++i)
+	{
+		if (state.objects[i].type == ObjectType::OBJ_SHIP && state.objects[i].identifier == identifier)
+		{
+			centre = state.objects[i].transform.position;
+			break;
+		}
+	}
+
+	// Kept across calls, the server sends snapshots from one thread
+	static float priority[MAX_NETWORK_OBJECTS];
+	for (uint32_t i = 0; i < state.objectCount; ++i)
+	{
+		NetworkObject const& object = state.objects[i];
+		float dx = object.transform.position.x - centre.x;
+		float dy = object.transform.position.y - centre.y;
+
+		float rank = 0.0f;
+		switch (object.type)
+		{
+		case ObjectType::OBJ_SHIP:		rank = 0.0f; break;
+		case ObjectType::OBJ_ASTEROID:	rank = 1.0f; break;
+		case ObjectType::OBJ_WALL:		rank = 2.0f; break;
+		case ObjectType::OBJ_BULLET:	rank = 3.0f; break;
+		}
+
+		priority[i] = rank * PRIORITY_TYPE_WEIGHT + dx * dx + dy * dy;
+		order[i] = static_cast<uint16_t>(i);
+	}
+
+	std::stable_sort(order, order + state.objectCount,
+		[](uint16_t a, uint16_t b) { return priority[a] < priority[b]; });
+}
+
+uint32_t WriteSnapshotFragments(NetworkGameState const& state, NetworkGameState const* baseline, uint16_t const* order,
+								NetworkGameState& reconstructed, SnapshotFragment* fragments)
+{
+	uint32_t baselineSequence = baseline ? baseline->sequenceNumber : SNAPSHOT_NO_BASELINE;
+	uint32_t ticks = baseline ? state.sequenceNumber - baseline->sequenceNumber : 0;
+
+	// The receiver starts from its copy of the baseline
+	BeginSnapshot(reconstructed, baseline, state.sequenceNumber, state.playerCount, state.objectCount);
+	reconstructed.inputTick = state.inputTick;
+
+	uint32_t fragmentCount = 1;
+	bool full = false;
+	BitWriter writer(fragments[0].data, SNAPSHOT_FRAGMENT_SIZE);
+	WriteFragmentHeader(writer, state, baselineSequence, 0);
+
+	// Players always go in the first fragment
+	for (uint32_t i = 0; i < state.playerCount; ++i)
+	{
+		NetworkPlayerData const& player = state.playerData[i];
+		bool hasBaseline = baseline && i < baseline->playerCount;
+		uint8_t mask = hasBaseline ? GetPlayerDeltaMask(player, baseline->playerData[i]) : static_cast<uint8_t>(PLAYER_ALL);
+
+		writer.WriteBits(mask, PLAYER_MASK_BITS);
+		if (mask & PLAYER_IDENTIFIER)	writer.WriteBits(player.identifier, 32);
+		if (mask & PLAYER_SCORE)		writer.WriteBits(player.score, 32);
+		if (mask & PLAYER_LIVES)		writer.WriteBits(player.lives, 32);
+
+		ApplyPlayerDelta(reconstructed.playerData[i], player, mask);
+	}
+
+	for (uint32_t k = 0; k < state.objectCount; ++k)
+	{
+		uint32_t i = order[k];
+
+		// Compare what the receiver would decode, so unchanged fields are not resent
+		NetworkObject object = state.objects[i];
+		object.transform = QuantizeTransform(object.transform, object.type);
+
+		bool hasBaseline = baseline && i < baseline->objectCount;
+		uint8_t mask = hasBaseline ? GetObjectDeltaMask(object, baseline->objects[i], ticks) : GetFullObjectMask(object.type);
+
+		// Objects the receiver already predicts correctly are not sent at all
+		if (mask == 0)
+		{
+			continue;
+		}
+
+		// Keep room for the end marker, and move on to the next fragment when this one is full
+		if (writer.GetBitsRemaining() < MAX_OBJECT_ENTRY_BITS + 1)
+		{
+			writer.WriteBool(false);
+			fragments[fragmentCount - 1].size = writer.GetBytesWritten();
+
+			if (fragmentCount == MAX_SNAPSHOT_FRAGMENTS)
+			{
+				full = true;
+				break;
+			}
+
+			writer = BitWriter(fragments[fragmentCount].data, SNAPSHOT_FRAGMENT_SIZE);
+			WriteFragmentHeader(writer, state, baselineSequence, fragmentCount);
+			++fragmentCount;
+		}
+
+		writer.WriteBool(true);
+		writer.WriteBits(i, OBJECT_INDEX_BITS);
+		writer.WriteBits(mask, OBJECT_MASK_BITS);
+		if (mask & OBJECT_TYPE)			writer.WriteBits(static_cast<uint32_t>(object.type), OBJECT_TYPE_BITS);
+		if (mask & OBJECT_IDENTIFIER)	writer.WriteBits(object.identifier, 16);
+		if (mask & OBJECT_POSITION)		WritePosition(writer, object.transform.position);
+		if (mask & OBJECT_VELOCITY)		WriteVelocity(writer, object.transform.velocity);
+		if (mask & OBJECT_ROTATION)		WriteRotation(writer, object.transform.rotation);
+		if (mask & OBJECT_SCALE)		WriteScale(writer, object.transform.scale);
+
+		reconstructed.objects[i] = hasBaseline ? baseline->objects[i] : NetworkObject{};
+		ApplyObjectDelta(reconstructed.objects[i], object, mask, ticks);
+	}
+
+	// The last fragment is still open unless the loop stopped at the fragment limit
+	if (!full)
+	{
+		writer.WriteBool(false);
+		fragments[fragmentCount - 1].size = writer.GetBytesWritten();
+	}
+
+	for (uint32_t f = 0; f < fragmentCount; ++f)
+	{
+		BitWriter(fragments[f].data + FRAGMENT_COUNT_OFFSET, 1).WriteBits(fragmentCount, FRAGMENT_INDEX_BITS);
+	}
+	return fragmentCount;
+}
+
+SnapshotAssembly* ReadSnapshotFragment(char const* buffer, size_t size, SnapshotBuffer const& baselines,
+									   SnapshotAssembly* assemblies)
+{
+	BitReader reader(buffer, size);
+
+	uint32_t sequenceNumber = reader.ReadBits(32);
+	uint32_t baselineSequence = reader.ReadBits(32);
+	uint32_t fragmentCount = reader.ReadBits(FRAGMENT_INDEX_BITS);
+	uint32_t fragmentIndex = reader.ReadBits(FRAGMENT_INDEX_BITS);
+	uint32_t playerCount = reader.ReadBits(PLAYER_COUNT_BITS);
+	uint32_t objectCount = reader.ReadBits(OBJECT_COUNT_BITS);
+	uint32_t inputTick = reader.ReadBits(32);
+
+	if (reader.HasOverflowed() || fragmentCount == 0 || fragmentCount > MAX_SNAPSHOT_FRAGMENTS ||
+		fragmentIndex >= fragmentCount || playerCount > MAX_PLAYERS || objectCount > MAX_NETWORK_OBJECTS)
+	{
+		return nullptr;
+	}
+
+	// A delta can only be decoded if its baseline was kept
+	NetworkGameState const* baseline = baselines.Find(baselineSequence);
+	if (baselineSequence != SNAPSHOT_NO_BASELINE && baseline == nullptr)
+	{
+		return nullptr;
+	}
+
+	uint32_t ticks = baseline ? sequenceNumber - baseline->sequenceNumber : 0;
+
+	SnapshotAssembly& assembly = assemblies[sequenceNumber % SNAPSHOT_ASSEMBLY_COUNT];
+	if (!assembly.active || assembly.state.sequenceNumber != sequenceNumber)
+	{
+		// Late fragments must not replace a newer snapshot sharing the slot
+		if (assembly.active && static_cast<int32_t>(sequenceNumber - assembly.state.sequenceNumber) < 0)
+		{
+			return nullptr;
+		}
+
+		BeginSnapshot(assembly.state, baseline, sequenceNumber, playerCount, objectCount);
+		assembly.state.inputTick = inputTick;
+		assembly.baselineSequence = baselineSequence;
+		assembly.fragmentCount = fragmentCount;
+		assembly.receivedFragments = 0;
+		assembly.active = true;
+	}
+	else if (assembly.baselineSequence != baselineSequence || assembly.fragmentCount != fragmentCount ||
+			 assembly.state.playerCount != playerCount || assembly.state.objectCount != objectCount)
+	{
+		return nullptr;
+	}
+
+	if (assembly.receivedFragments & (1u << fragmentIndex))
+	{
+		return nullptr;
+	}
+
+	// Changes are applied straight into the assembly, a malformed fragment discards the whole snapshot
+	NetworkGameState& result = assembly.state;
+	bool valid = true;
+
+	if (fragmentIndex == 0)
+	{
+		for (uint32_t i = 0; i < playerCount && valid; ++i)
+		{
+			NetworkPlayerData delta;
+			uint8_t mask = static_cast<uint8_t>(reader.ReadBits(PLAYER_MASK_BITS));
+
+			if (mask & PLAYER_IDENTIFIER)	delta.identifier = reader.ReadBits(32);
+			if (mask & PLAYER_SCORE)		delta.score = reader.ReadBits(32);
+			if (mask & PLAYER_LIVES)		delta.lives = reader.ReadBits(32);
+
+			// Players without a baseline must be sent in full
+			valid = (baseline && i < baseline->playerCount) || mask == PLAYER_ALL;
+			ApplyPlayerDelta(result.playerData[i], delta, mask);
+		}
+	}
+
+	while (valid && reader.ReadBool())
+	{
+		uint32_t i = reader.ReadBits(OBJECT_INDEX_BITS);
+		uint8_t mask = static_cast<uint8_t>(reader.ReadBits(OBJECT_MASK_BITS));
+		if (i >= objectCount)
+		{
+			valid = false;
+			break;
+		}
+
+		bool hasBaseline = baseline && i < baseline->objectCount;
+		NetworkObject& object = result.objects[i];
+		object = hasBaseline ? baseline->objects[i] : NetworkObject{};
+
+		// The type decides whether the scale was sent
+		NetworkObject delta{};
+		delta.type = (mask & OBJECT_TYPE) ? static_cast<ObjectType>(reader.ReadBits(OBJECT_TYPE_BITS)) : object.type;
+
+		if (mask & OBJECT_IDENTIFIER)	delta.identifier = static_cast<uint16_t>(reader.ReadBits(16));
+		if (mask & OBJECT_POSITION)		delta.transform.position = ReadPosition(reader);
+		if (mask & OBJECT_VELOCITY)		delta.transform.velocity = ReadVelocity(reader);
+		if (mask & OBJECT_ROTATION)		delta.transform.rotation = ReadRotation(reader);
+		if (mask & OBJECT_SCALE)		delta.transform.scale = ReadScale(reader);
+
+		// Objects without a baseline must be sent in full
+		valid = hasBaseline || mask == GetFullObjectMask(delta.type);
+		ApplyObjectDelta(object, delta, mask, ticks);
+	}
+
+	if (!valid || reader.HasOverflowed())
+	{
+		assembly.active = false;
+		return nullptr;
+	}
+
+	assembly.receivedFragments |= 1u << fragmentIndex;
+	return &assembly;
+}
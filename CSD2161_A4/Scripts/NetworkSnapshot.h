@@ -0,0 +1,102 @@
+/******************************************************************************/
+/*!
+\file		NetworkSnapshot.h
+\author
+\par
+\date
+\brief		This file declares the functions and structures used to delta
+			encode the networked game state against the last snapshot that
+			a client has acknowledged, split into fragments that each fit
+			one datagram and can be decoded on their own.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef NETWORK_SNAPSHOT
+#define NETWORK_SNAPSHOT // header guard
+
+#include <cstdint>					// uint32_t
+#include <cstddef>					// size_t
+
+#include "NetworkGameState.h"		// NetworkGameState
+#include "SequenceBuffer.h"			// SequenceBuffer
+#include "NetworkRateControl.h"		// SnapshotRateControl
+
+#define SNAPSHOT_BUFFER_SIZE	32			// number of snapshots kept as possible baselines
+#define SNAPSHOT_NO_BASELINE	SEQUENCE_BUFFER_EMPTY	// sequence number used when there is no baseline
+#define SNAPSHOT_INTERVAL_MS	16			// time between two snapshots, each client is sent one every few of them
+#define SNAPSHOT_POSITION_ERROR	0.5f		// largest position error allowed before it is resent
+#define SNAPSHOT_FRAGMENT_SIZE	1024		// payload bytes of one fragment, kept below the usual MTU
+#define MAX_SNAPSHOT_FRAGMENTS	16			// fragments sent per snapshot, objects that do not fit wait for the next one
+#define SNAPSHOT_ASSEMBLY_COUNT	4			// snapshots the client can be rebuilding at the same time
+
+// Ring of the most recent snapshots, indexed by their sequence number
+struct SnapshotBuffer
+{
+	SequenceBuffer<NetworkGameState, SNAPSHOT_BUFFER_SIZE> snapshots;
+
+	// Stores the snapshot, overwriting the oldest one in its slot
+	void Store(NetworkGameState const& snapshot);
+
+	// Returns the snapshot with the sequence number, or nullptr if it is no longer kept
+	NetworkGameState const* Find(uint32_t sequenceNumber) const;
+
+	// Forgets every stored snapshot
+	void Clear();
+};
+
+// One datagram worth of an encoded snapshot
+struct SnapshotFragment
+{
+	char data[SNAPSHOT_FRAGMENT_SIZE];
+	size_t size = 0;
+};
+
+// Snapshot the client is rebuilding from its fragments. Fragments are applied as they arrive, so
+// objects they carry are up to date even if another fragment of the snapshot is lost
+struct SnapshotAssembly
+{
+	NetworkGameState state;							// baseline with the fragments received so far applied
+	uint32_t baselineSequence = SNAPSHOT_NO_BASELINE;
+	uint32_t fragmentCount = 0;
+	uint32_t receivedFragments = 0;					// one bit per fragment index received
+	bool active = false;
+
+	// Returns true once every fragment has been applied, the snapshot can then be acknowledged
+	bool IsComplete() const;
+};
+
+// Delta compression state the server keeps for each client
+struct ClientSnapshotState
+{
+	SnapshotBuffer sent;								// snapshots as the client will reconstruct them
+	uint32_t ackedSequence = SNAPSHOT_NO_BASELINE;		// latest snapshot acknowledged by the client
+	SnapshotRateControl rate;							// how often the client is sent a snapshot
+};
+
+// Function to copy only the players and objects in use, the rest of the arrays are left untouched
+void CopyGameState(NetworkGameState& destination, NetworkGameState const& source);
+
+// Function to order the objects by how important they are to the player with the identifier:
+// ships first, then asteroids and walls by distance to the player's ship, then bullets
+// order must hold state.objectCount indices
+void GetSnapshotPriorityOrder(NetworkGameState const& state, uint16_t identifier, uint16_t* order);
+
+// Function to encode the state as a delta against the baseline (nullptr sends the full state)
+// Objects are written in the given order, so when MAX_SNAPSHOT_FRAGMENTS is reached the ones left
+// out are the least important, and are predicted from the baseline until a later snapshot.
+// The state the receiver will reconstruct once it has every fragment is written to reconstructed,
+// and should be stored as the future baseline. Returns the number of fragments written
+uint32_t WriteSnapshotFragments(NetworkGameState const& state, NetworkGameState const* baseline, uint16_t const* order,
+								NetworkGameState& reconstructed, SnapshotFragment* fragments);
+
+// Function to decode one fragment into the assembly of its snapshot, using the baselines received
+// assemblies must hold SNAPSHOT_ASSEMBLY_COUNT entries. Returns the assembly that was updated, or
+// nullptr if the fragment is malformed, a duplicate, too old, or its baseline is no longer available
+SnapshotAssembly* ReadSnapshotFragment(char const* buffer, size_t size, SnapshotBuffer const& baselines,
+									   SnapshotAssembly* assemblies);
+
+#endif
@@ -0,0 +1,110 @@
+/******************************************************************************/
+/*!
+\file		Platform.h
+\author
+\par
+\date
+\brief		This file includes the socket API of the platform. Winsock is
+			used on Windows, elsewhere the Berkeley sockets are given the
+			Winsock names used by the network code, along with the few
+			Windows only functions of the server, so the dedicated server
+			also builds on Linux.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef PLATFORM
+#define PLATFORM // header guard
+
+#ifdef _WIN32
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#include "Windows.h"		// Entire Win32 API...
+// #include "winsock2.h"	// ...or Winsock alone
+#include "ws2tcpip.h"		// getaddrinfo()
+
+// Tell the Visual Studio linker to include the following library in linking.
+// Alternatively, we could add this file to the linker command-line parameters,
+// but including it in the source code simplifies the configuration.
+#pragma comment(lib, "ws2_32.lib")
+
+#else
+
+#include <sys/socket.h>		// socket, sendto, recvfrom
+#include <sys/select.h>		// select
+#include <netinet/in.h>		// sockaddr_in
+#include <arpa/inet.h>		// inet_ntop
+#include <netdb.h>			// getaddrinfo, getnameinfo
+#include <unistd.h>			// close, gethostname
+#include <cerrno>			// errno
+#include <cstring>			// memset
+#include <ctime>			// localtime_r
+#include <chrono>			// std::chrono::milliseconds
+#include <thread>			// std::this_thread::sleep_for
+
+typedef int SOCKET;
+typedef struct WSAData {} WSADATA;
+
+#define INVALID_SOCKET				(-1)
+#define SOCKET_ERROR				(-1)
+#define SD_SEND						SHUT_WR
+#define MAKEWORD(low, high)			((unsigned short)(((low) & 0xff) | (((high) & 0xff) << 8)))
+#define UNREFERENCED_PARAMETER(P)	(void)(P)
+
+// Berkeley sockets need no start up or clean up
+inline int WSAStartup(unsigned short version, WSADATA* data)
+{
+	UNREFERENCED_PARAMETER(version);
+	UNREFERENCED_PARAMETER(data);
+	return 0;
+}
+
+inline int WSACleanup()
+{
+	return 0;
+}
+
+inline int WSAGetLastError()
+{
+	return errno;
+}
+
+inline int closesocket(SOCKET socket)
+{
+	return close(socket);
+}
+
+inline void Sleep(unsigned long milliseconds)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+inline void SecureZeroMemory(void* destination, size_t size)
+{
+	memset(destination, 0, size);
+}
+
+inline int localtime_s(std::tm* result, std::time_t const* time)
+{
+	return localtime_r(time, result) ? 0 : errno;
+}
+
+// Copies at most count characters, truncating to fit the destination
+template <size_t Size>
+inline int strncpy_s(char (&destination)[Size], char const* source, size_t count)
+{
+	size_t length = strnlen(source, count < Size ? count : Size - 1);
+	memcpy(destination, source, length);
+	destination[length] = '\0';
+	return 0;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,53 @@
+/******************************************************************************/
+/*!
+\file		SequenceBuffer.h
+\author
+\par
+\date
+\brief		This file declares a fixed capacity ring of entries indexed by
+			sequence number, used for the packets and snapshots kept by the
+			network code without any allocation.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef SEQUENCE_BUFFER
+#define SEQUENCE_BUFFER // header guard
+
+#include <cstdint>					// uint32_t
+#include <cstddef>					// size_t
+
+#define SEQUENCE_BUFFER_EMPTY	UINT32_MAX	// sequence number of a slot holding nothing
+
+// Each sequence number maps to the slot sequence % Capacity, so any Capacity consecutive sequence
+// numbers can be kept at the same time. Inserting overwrites whatever was in the slot
+template <typename TEntry, size_t Capacity>
+class SequenceBuffer
+{
+public:
+	SequenceBuffer();
+
+	// Claims the slot of the sequence number and returns its entry, left as it was before
+	TEntry& Insert(uint32_t sequence);
+
+	// Returns the entry of the sequence number, or nullptr if the slot holds another one
+	TEntry* Find(uint32_t sequence);
+	TEntry const* Find(uint32_t sequence) const;
+
+	bool Exists(uint32_t sequence) const;
+	void Remove(uint32_t sequence);
+	void Clear();
+
+private:
+	static size_t GetSlot(uint32_t sequence);
+
+	uint32_t _sequences[Capacity];
+	TEntry _entries[Capacity];
+};
+
+#include "SequenceBuffer.hpp"
+
+#endif
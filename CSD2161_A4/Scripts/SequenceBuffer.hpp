@@ -0,0 +1,80 @@
+/******************************************************************************/
+/*!
+\file		SequenceBuffer.hpp
+\author
+\par
+\date
+\brief		This file contains the definitions of the fixed capacity ring of
+			entries indexed by sequence number.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef SEQUENCE_BUFFER_HPP
+#define SEQUENCE_BUFFER_HPP // header guard
+
+#include "SequenceBuffer.h"
+
+template <typename TEntry, size_t Capacity>
+SequenceBuffer<TEntry, Capacity>::SequenceBuffer()
+{
+	Clear();
+}
+
+template <typename TEntry, size_t Capacity>
+size_t SequenceBuffer<TEntry, Capacity>::GetSlot(uint32_t sequence)
+{
+	return sequence % Capacity;
+}
+
+template <typename TEntry, size_t Capacity>
+TEntry& SequenceBuffer<TEntry, Capacity>::Insert(uint32_t sequence)
+{
+	size_t slot = GetSlot(sequence);
+	_sequences[slot] = sequence;
+	return _entries[slot];
+}
+
+template <typename TEntry, size_t Capacity>
+TEntry* SequenceBuffer<TEntry, Capacity>::Find(uint32_t sequence)
+{
+	size_t slot = GetSlot(sequence);
+	return (sequence != SEQUENCE_BUFFER_EMPTY && _sequences[slot] == sequence) ? _entries + slot : nullptr;
+}
+
+template <typename TEntry, size_t Capacity>
+TEntry const* SequenceBuffer<TEntry, Capacity>::Find(uint32_t sequence) const
+{
+	size_t slot = GetSlot(sequence);
+	return (sequence != SEQUENCE_BUFFER_EMPTY && _sequences[slot] == sequence) ? _entries + slot : nullptr;
+}
+
+template <typename TEntry, size_t Capacity>
+bool SequenceBuffer<TEntry, Capacity>::Exists(uint32_t sequence) const
+{
+	return Find(sequence) != nullptr;
+}
+
+template <typename TEntry, size_t Capacity>
+void SequenceBuffer<TEntry, Capacity>::Remove(uint32_t sequence)
+{
+	size_t slot = GetSlot(sequence);
+	if (_sequences[slot] == sequence)
+	{
+		_sequences[slot] = SEQUENCE_BUFFER_EMPTY;
+	}
+}
+
+template <typename TEntry, size_t Capacity>
+void SequenceBuffer<TEntry, Capacity>::Clear()
+{
+	for (uint32_t& sequence : _sequences)
+	{
+		sequence = SEQUENCE_BUFFER_EMPTY;
+	}
+}
+
+#endif
@@ -0,0 +1,259 @@
+/******************************************************************************/
+/*!
+\file		Server.cpp
+\author
+\par
+\date
+\brief		This file contains the dedicated server: the lobby accepting the
+			clients, the event loop running the game, and the leaderboard saved
+			once the game ends. It is shared by the game and the headless
+			server, so it does not depend on the Alpha Engine.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "Server.h"
+
+#include "Network.h"				// networking for multiplayer
+#include "NetworkConnection.h"		// GetNextConnectionDeadline, UpdateConnections
+#include "NetworkEventLoop.h"		// NetworkEventLoop
+#include "NetworkSnapshot.h"		// SNAPSHOT_INTERVAL_MS
+#include "ServerSimulation.h"		// InitSimulation, UpdateSimulation
+#include "Logger.h"					// LOG_INFO, LOG_WARNING, LOG_ERROR
+#include <ctime>					// std::time, std::strftime
+#include <algorithm>				// std::min
+
+static bool IsAnyClientConnected(std::map<uint16_t, sockaddr_in> const& clients)
+{
+	for (auto& [portID, address] : clients)
+	{
+		if (isPlayerConnected[portID])
+			return true;
+	}
+	return false;
+}
+
+// Runs the game on the calling thread until every client left. The thread sleeps until a packet
+// arrives, a packet must be resent, a simulation step or the next snapshot is due, so no time is
+// spent polling. The simulation keeps its own fixed rate, whatever the rate snapshots are sent at
+static void RunGame(NetworkEventLoop& eventLoop, std::map<uint16_t, sockaddr_in>& clients)
+{
+	uint64_t nextSnapshot = GetTimeNow();
+
+	while (IsAnyClientConnected(clients))
+	{
+		uint64_t deadline = (std::min)({ GetNextSimulationStep(), nextSnapshot, GetNextConnectionDeadline() });
+		if (eventLoop.Wait(deadline))
+		{
+			// Each packet goes to the queue of its client until the next step
+			ReceiveClientPackets(udpServerSocket);
+		}
+
+		uint64_t now = GetTimeNow();
+
+		// ACKs normally ride on the game state, only send them alone if it stopped
+		UpdateConnections(now);
+
+		// Inputs received so far hold for every step run by this update
+		if (now >= GetNextSimulationStep())
+		{
+			for (auto& [portID, address] : clients)
+			{
+				HandleClientPackets(portID, playerDataMap);
+			}
+			UpdateSimulation(now);
+		}
+
+		if (now < nextSnapshot)
+			continue;
+
+		UpdateGameLoop(clients);
+		BroadcastGameState(udpServerSocket, clients);
+
+		// Snapshots missed while the thread was late are skipped instead of sent back to back
+		nextSnapshot += SNAPSHOT_INTERVAL_MS;
+		if (nextSnapshot <= now)
+			nextSnapshot = now + SNAPSHOT_INTERVAL_MS;
+	}
+}
+
+void RunServer()
+{
+	sockaddr_in address{};
+	std::map<uint16_t, sockaddr_in> clients;                    // source_port : sockaddr_in mapping
+    NetworkEventLoop eventLoop(udpServerSocket);
+
+	int clientsRequired = 2;
+	int clientCount = 0;
+
+	bool gameStarted = false; // Add a flag
+
+    while (!gameStarted)
+    {
+        // Wake for a packet, or to resend the lobby messages the clients have not acknowledged
+        if (!eventLoop.Wait(GetNextConnectionDeadline()))
+        {
+            RetransmitPacket();
+            continue;
+        }
+
+        NetworkPacket packet = ReceivePacket(udpServerSocket, address);
+
+        // need to check that the packet is valid then record the time
+        if (packet.packetID != UINT16_MAX)
+        {
+            uint16_t port = packet.sourcePortNumber;
+            lastHeardTime[port] = GetTimeNow();
+
+            // check the map to ensure client is connected BEFORE!
+            // if they not connected before, mark them connected
+            if (isPlayerConnected.find(port) == isPlayerConnected.end() ||
+                !isPlayerConnected[port])
+            {
+                isPlayerConnected[port] = true;
+                LOG_INFO("[Server] Player " << port << " is now connected.");
+            }
+        }
+
+        if (packet.packetID == REQ_CONNECT) {
+
+            // Sends acknowledgment
+            HandleConnectionRequest(udpServerSocket, address, packet);
+
+        }
+        else if (packet.packetID == REQ_QUIT) {
+
+            LOG_INFO("Disconnecting client at port number: " << std::to_string(packet.sourcePortNumber));
+            --clientCount;
+            clientCountGlobal = clientCount;
+            BroadcastClientCount(udpServerSocket, clients);
+
+        }
+        else if (packet.packetID == JOIN_REQUEST) {
+
+            uint16_t portID = packet.sourcePortNumber;
+
+            if (clientCount == clientsRequired && clients.count(portID) == false)
+            {
+                // ignore request, lobby is full
+                LOG_INFO("[Server] Ignoring join, server is full");
+                continue;
+            }
+
+            HandleJoinRequest(udpServerSocket, address, packet);
+
+            isPlayerConnected[portID] = true;
+            lastHeardTime[portID] = GetTimeNow();
+            LOG_INFO("[Server] Client [" << portID << "] has joined.");
+
+            // Check if the client is in the map already
+            if (clients.count(packet.sourcePortNumber) == false)
+            {
+                // Add the client port to IP to map
+                clients[packet.sourcePortNumber] = address;
+                ++clientCount;
+
+                clientCountGlobal = clientCount;
+
+                BroadcastClientCount(udpServerSocket, clients);
+
+                // Create the player data and store it with the port number as key
+                switch (clientCount)
+                {
+                case 1:
+                {
+                    AEVec2 posVec{ 100, 100 };
+                    AEVec2 scaleVec{ 16, 16 };
+
+                    playerDataMap.emplace(packet.sourcePortNumber, PlayerData(posVec, scaleVec));
+                    break;
+                }
+                case 2:
+                {
+                    AEVec2 posVec{ 200, 200 };
+                    AEVec2 scaleVec{ 16, 16 };
+
+                    playerDataMap.emplace(packet.sourcePortNumber, PlayerData(posVec, scaleVec));
+                    break;
+                }
+                case 3:
+                {
+                    AEVec2 posVec{ 300, 300 };
+                    AEVec2 scaleVec{ 16, 16 };
+
+                    playerDataMap.emplace(packet.sourcePortNumber, PlayerData(posVec, scaleVec));
+                    break;
+                }
+                case 4:
+                {
+                    AEVec2 posVec{ 400, 400 };
+                    AEVec2 scaleVec{ 16, 16 };
+
+                    playerDataMap.emplace(packet.sourcePortNumber, PlayerData(posVec, scaleVec));
+                    break;
+                }
+                }
+                LOG_INFO("Num Players: " << playerDataMap.size());
+            }
+
+            // Can start game when players is max
+            if (clientCount == clientsRequired)
+            {
+                // Stop accepting new clients
+                gameStarted = true;
+
+                // Each client gets its own queue of packets
+                OpenClientQueues(clients);
+
+                // The world starts with the players where the lobby placed them
+                InitSimulation(GetTimeNow());
+                WriteSimulationState(gameDataState);
+
+                for (auto& [p, addr] : clients)
+                {
+                    if (playerDataMap.count(p)) // Check if key 'p' exists in the map
+                    {
+                        SendGameStateStart(udpServerSocket, addr, playerDataMap[p]);
+                    }
+                    else
+                    {
+                        LOG_ERROR("Player " << p << " not found in playersData!");
+                    }
+                }
+            }
+        } else {
+            if (packet.packetID != UINT16_MAX) {
+                LOG_WARNING("Received unknown packet from " << packet.sourcePortNumber);
+            }
+            
+        }
+
+        // Resend the lobby messages the clients have not acknowledged
+        RetransmitPacket();
+    }
+    
+	RunGame(eventLoop, clients);
+
+	// Collate scores onto the leaderboard
+	LoadLeaderboard();
+
+	// Get current time
+	char timeBuffer[20];
+	std::time_t currentTime = std::time(nullptr);
+	std::tm localTime;
+	localtime_s(&localTime, &currentTime);
+	std::strftime(timeBuffer, 20, "%Y-%m-%d %H:%M:%S", &localTime);
+
+	for (auto [id, score, lives] : gameDataState.playerData)
+	{
+		AddScoreToLeaderboard(id, "", score, timeBuffer);
+	}
+	SaveLeaderboard();
+
+	// End of game, send the final leaderboard to the clients
+	BroadcastLeaderboard(udpServerSocket, std::ref(clients));
+}
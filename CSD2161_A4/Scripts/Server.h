@@ -0,0 +1,23 @@
+/******************************************************************************/
+/*!
+\file		Server.h
+\author
+\par
+\date
+\brief		This file declares the dedicated server loop, run by the game
+			when started as a server and by the headless server.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef DEDICATED_SERVER
+#define DEDICATED_SERVER // header guard
+
+// Function to run the lobby until enough clients joined, then the game until every client left
+// The server socket must be started, it is left open for the caller to disconnect
+void RunServer();
+
+#endif
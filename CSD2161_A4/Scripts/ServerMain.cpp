@@ -0,0 +1,44 @@
+/******************************************************************************/
+/*!
+\file		ServerMain.cpp
+\author
+\par
+\date
+\brief		This file contains the 'main' function of the headless server,
+			which runs the dedicated server without any window or graphics.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+/******************************************************************************/
+
+#include "Network.h"	// networking for multiplayer
+#include "Server.h"		// RunServer
+
+/******************************************************************************/
+/*!
+\brief
+	Main driver function of the headless server. The port is read from the
+	configuration file, as for the server started from the game.
+
+\return int
+*/
+/******************************************************************************/
+int main()
+{
+	networkType = NetworkType::SERVER;
+	if (StartServer() != 0)
+	{
+		std::cerr << "Error Starting Server" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Processing Server..." << std::endl;
+
+	// Runs the lobby and the game until every client left
+	RunServer();
+
+	Disconnect(udpServerSocket);
+	return 0;
+}
@@ -0,0 +1,431 @@
+/******************************************************************************/
+/*!
+\file		ServerSimulation.cpp
+\author
+\par
+\date
+\brief		This file defines the authoritative simulation run by the server.
+			It follows the rules of the single player game state for every
+			ship, with time measured in fixed steps instead of frames.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#include "ServerSimulation.h"
+
+#include "GameData.h"				// playerDataMap, playerInputQueueMap, asteroids, playerBulletMap
+#include "ShipMovement.h"			// MoveShip, GetBoundingBox, WrapPosition
+#include "CollisionBroadphase.h"	// CreateCollisionBroadphase, collisionBroadphaseType
+#include "Logger.h"					// LOG_INFO
+
+#include <cmath>					// cosf, sinf, std::ceil, std::fmod
+#include <algorithm>				// std::clamp
+
+// Keys of the objects in the broadphase, asteroids use their identifier
+#define SHIP_BROADPHASE_KEY			0x10000u	// + portID
+#define BULLET_BROADPHASE_KEY		0x20000u	// + index of the bullet, bullets have no identifier
+
+uint32_t simulationTickRate = SIMULATION_TICK_RATE;
+
+static double stepMs;								// length of a step in milliseconds
+static float stepSeconds;							// length of a step in seconds, the dt of every step
+static uint64_t lastUpdate;							// time of the last UpdateSimulation
+static double accumulator;							// time not simulated yet, in milliseconds
+static uint32_t randomState;						// state of the asteroid spawner
+static uint32_t pendingAsteroids;					// asteroids to spawn at the end of the step
+static uint16_t nextAsteroidID;						// identifier of the next asteroid spawned
+
+static std::vector<uint16_t> asteroidIDs;			// follows the order of asteroids, lets clients match them across snapshots
+
+static NetworkTransform wall;
+static std::map<uint16_t, AEVec2> spawnPositions;	// portID -> position the ship restarts from
+
+// Bounding boxes before the step. Ships and bullets follow the order of playerDataMap
+static std::vector<AABB> shipBoxes;
+static std::vector<AABB> asteroidBoxes;
+static std::vector<AABB> bulletBoxes;
+static std::vector<uint16_t> shipPorts;
+static std::vector<uint16_t> bulletPorts;
+static std::vector<AEVec2> bulletVelocities;
+static std::vector<bool> asteroidHit;
+static std::vector<bool> bulletHit;
+
+// Ships and bullets are numbered ships first, so an asteroid tests the ships first
+static std::unique_ptr<CollisionBroadphase> broadphase;
+static std::vector<uint32_t> candidates;
+static std::vector<uint32_t> testedCandidates;		// candidates still in the game, in the order of candidateBoxes
+static AABBBatch candidateBoxes;
+static std::vector<float> candidateTimes;			// first time of collision with each candidate tested
+
+// Deterministic replacement for AERandFloat, returns a value in [0, 1)
+static float RandomFloat()
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return (randomState >> 8) * (1.0f / 16777216.0f);
+}
+
+static void Move(NetworkTransform& transform, float dt)
+{
+	transform.position.x += transform.velocity.x * dt;
+	transform.position.y += transform.velocity.y * dt;
+}
+
+static void AddAsteroid(AEVec2 const& pos, AEVec2 const& vel, AEVec2 const& scale)
+{
+	asteroids.emplace_back(pos, vel, 0.0f, scale);
+	asteroidIDs.push_back(nextAsteroidID++);
+}
+
+static bool IsShipActive(uint16_t portID, PlayerData const& player)
+{
+	return isPlayerConnected[portID] && player.stats.lives > 0;
+}
+
+// Creates an asteroid along the edge of the screen with a random velocity and size
+static void SpawnRandomAsteroid()
+{
+	AEVec2 pos, vel, scale;
+
+	switch (static_cast<int>(RandomFloat() * 4))
+	{
+	default:
+	case 0:  // Top edge
+		pos.x = (RandomFloat() - 0.5f) * SCREEN_SIZE_X;
+		pos.y = SCREEN_SIZE_Y * 0.5f;
+		break;
+
+	case 1:  // Right edge
+		pos.x = SCREEN_SIZE_X * 0.5f;
+		pos.y = (RandomFloat() - 0.5f) * SCREEN_SIZE_Y;
+		break;
+
+	case 2:  // Bottom edge
+		pos.x = (RandomFloat() - 0.5f) * SCREEN_SIZE_X;
+		pos.y = -SCREEN_SIZE_Y * 0.5f;
+		break;
+
+	case 3:  // Left edge
+		pos.x = -SCREEN_SIZE_X * 0.5f;
+		pos.y = (RandomFloat() - 0.5f) * SCREEN_SIZE_Y;
+		break;
+	}
+
+	// randomise the velocity between (-min to -max and min to max)
+	float sign = (RandomFloat() > 0.5f) ? 1.0f : -1.0f;
+	vel.x = sign * (ASTEROID_MIN_VEL + RandomFloat() * (ASTEROID_MAX_VEL - ASTEROID_MIN_VEL));
+
+	sign = (RandomFloat() > 0.5f) ? 1.0f : -1.0f;
+	vel.y = sign * (ASTEROID_MIN_VEL + RandomFloat() * (ASTEROID_MAX_VEL - ASTEROID_MIN_VEL));
+
+	// randomise the scale between min and max
+	scale.x = ASTEROID_MIN_SCALE_X + RandomFloat() * (ASTEROID_MAX_SCALE_X - ASTEROID_MIN_SCALE_X);
+	scale.y = ASTEROID_MIN_SCALE_Y + RandomFloat() * (ASTEROID_MAX_SCALE_Y - ASTEROID_MIN_SCALE_Y);
+
+	AddAsteroid(pos, vel, scale);
+}
+
+// Fires a shot along the ship's direction
+static void FireShot(uint16_t portID, NetworkTransform const& ship)
+{
+	std::vector<NetworkTransform>& bullets = playerBulletMap[portID];
+	if (bullets.size() >= SIMULATION_MAX_BULLETS)
+		bullets.erase(bullets.begin());
+
+	AEVec2 velocity{ cosf(ship.rotation) * BULLET_SPEED, sinf(ship.rotation) * BULLET_SPEED };
+	bullets.emplace_back(ship.position, velocity, ship.rotation, AEVec2{ BULLET_SCALE_X, BULLET_SCALE_Y });
+}
+
+// Takes the input of the tick after the last one applied, a tick lost for good keeps the keys of the
+// one before. Returns false if the tick has not arrived yet
+static bool TakeNextInput(PlayerInputQueue& queue, bool& fired)
+{
+	uint32_t tick = queue.appliedTick + 1;
+	if (static_cast<int32_t>(queue.newestTick - tick) < 0)
+		return false;
+
+	bool wasFiring = queue.held.spaceKey;
+	if (uint8_t const* input = queue.inputs.Find(tick))
+		queue.held.Unpack(*input);
+	queue.appliedTick = tick;
+	fired = queue.held.spaceKey && !wasFiring;
+	return true;
+}
+
+// The ship goes back to its spawn point and a new asteroid replaces the one destroyed
+static void HitShip(size_t ship)
+{
+	uint16_t portID = shipPorts[ship];
+	PlayerData& player = playerDataMap[portID];
+	player.transform.position = spawnPositions[portID];
+	player.transform.velocity = { 0, 0 };
+	--player.stats.lives;
+	++pendingAsteroids;
+}
+
+// The bullet is destroyed with the asteroid and its owner scores
+static void HitBullet(size_t bullet)
+{
+	bulletHit[bullet] = true;
+	playerDataMap[bulletPorts[bullet]].stats.score += static_cast<uint32_t>(ASTEROID_SCORE);
+
+	// 10% chance to spawn 2 new asteroid instead of 1
+	pendingAsteroids += (RandomFloat() > 0.1f) ? 1 : 2;
+}
+
+static bool IsOutOfBounds(NetworkTransform const& transform)
+{
+	return transform.position.x > SCREEN_SIZE_X * 0.5f || transform.position.x < -SCREEN_SIZE_X * 0.5f ||
+		   transform.position.y > SCREEN_SIZE_Y * 0.5f || transform.position.y < -SCREEN_SIZE_Y * 0.5f;
+}
+
+static void AddObject(NetworkGameState& gameState, ObjectType type, uint16_t identifier, NetworkTransform const& transform)
+{
+	if (gameState.objectCount < MAX_NETWORK_OBJECTS)
+	{
+		gameState.objects[gameState.objectCount++] = NetworkObject{ type, identifier, transform };
+	}
+}
+
+void InitSimulation(uint64_t now)
+{
+	simulationTickRate = std::clamp<uint32_t>(simulationTickRate, SIMULATION_MIN_TICK_RATE, SIMULATION_MAX_TICK_RATE);
+	stepMs = 1000.0 / simulationTickRate;
+	stepSeconds = 1.0f / simulationTickRate;
+	lastUpdate = now;
+	accumulator = 0.0;
+	randomState = SIMULATION_SEED;
+	pendingAsteroids = 0;
+	nextAsteroidID = 0;
+	broadphase = CreateCollisionBroadphase(collisionBroadphaseType);
+	LOG_INFO("[Simulation] " << simulationTickRate << " steps per second, "
+			 << (collisionBroadphaseType == CollisionBroadphaseType::GRID ? "grid" : "sweep and prune") << " broadphase");
+
+	// Same opening as the single player game
+	asteroids.clear();
+	asteroidIDs.clear();
+	AddAsteroid(AEVec2{ 90.0f, -220.0f }, AEVec2{ -60.0f, -30.0f }, AEVec2{ ASTEROID_MIN_SCALE_X, ASTEROID_MAX_SCALE_Y });
+	AddAsteroid(AEVec2{ -260.0f, -250.0f }, AEVec2{ 39.0f, -130.0f }, AEVec2{ ASTEROID_MAX_SCALE_X, ASTEROID_MIN_SCALE_Y });
+	AddAsteroid(AEVec2{ -190.0f, 200.0f }, AEVec2{ -50.0f, 30.0f }, AEVec2{ ASTEROID_MIN_SCALE_X, ASTEROID_MAX_SCALE_Y });
+	AddAsteroid(AEVec2{ 210.0f, 100.0f }, AEVec2{ 40.0f, 70.0f }, AEVec2{ ASTEROID_MAX_SCALE_X, ASTEROID_MIN_SCALE_Y });
+	wall = NetworkTransform(AEVec2{ WALL_POSITION_X, WALL_POSITION_Y }, AEVec2{ 0, 0 }, 0.0f, AEVec2{ WALL_SCALE_X, WALL_SCALE_Y });
+
+	playerBulletMap.clear();
+	playerInputQueueMap.clear();
+	spawnPositions.clear();
+	for (auto& [portID, player] : playerDataMap)
+	{
+		spawnPositions[portID] = player.transform.position;
+		player.transform.velocity = { 0, 0 };
+		player.transform.rotation = 0.0f;
+		player.transform.scale = { SHIP_SCALE_X, SHIP_SCALE_Y };
+		player.stats.identifier = portID;
+		player.stats.score = 0;
+		player.stats.lives = SHIP_INITIAL_LIVES;
+	}
+}
+
+void UpdateSimulation(uint64_t now)
+{
+	accumulator += static_cast<double>(now - lastUpdate);
+	lastUpdate = now;
+
+	for (uint32_t steps = 0; accumulator >= stepMs; ++steps)
+	{
+		// A server that fell far behind drops the time instead of running every step at once
+		if (steps == SIMULATION_MAX_STEPS)
+		{
+			accumulator = std::fmod(accumulator, stepMs);
+			break;
+		}
+
+		StepSimulation(stepSeconds);
+		accumulator -= stepMs;
+	}
+}
+
+uint64_t GetNextSimulationStep()
+{
+	return lastUpdate + static_cast<uint64_t>(std::ceil(stepMs - accumulator));
+}
+
+void StepSimulation(float dt)
+{
+	// Bounding boxes are taken before moving, the collision test sweeps them over the step
+	shipBoxes.clear();
+	asteroidBoxes.clear();
+	bulletBoxes.clear();
+	shipPorts.clear();
+	bulletPorts.clear();
+	bulletVelocities.clear();
+
+	for (auto& [portID, player] : playerDataMap)
+	{
+		shipBoxes.push_back(GetBoundingBox(player.transform));
+		shipPorts.push_back(portID);
+		if (!IsShipActive(portID, player))
+			continue;
+
+		// Ships move one tick of input per step with the same code the clients predict them with,
+		// a client whose inputs piled up is caught up a tick per step, one whose inputs are late waits
+		PlayerInputQueue& queue = playerInputQueueMap[portID];
+		uint32_t ticks = queue.newestTick - queue.appliedTick > INPUT_MAX_BACKLOG ? 2 : 1;
+		bool fired = false;
+		for (uint32_t i = 0; i < ticks && TakeNextInput(queue, fired); ++i)
+		{
+			MoveShip(player.transform, queue.held, dt);
+			if (fired)
+				FireShot(portID, player.transform);
+		}
+	}
+	for (NetworkTransform& asteroid : asteroids)
+	{
+		asteroidBoxes.push_back(GetBoundingBox(asteroid));
+		Move(asteroid, dt);
+	}
+	for (auto& [portID, player] : playerDataMap)
+	{
+		for (NetworkTransform& bullet : playerBulletMap[portID])
+		{
+			bulletBoxes.push_back(GetBoundingBox(bullet));
+			bulletPorts.push_back(portID);
+			bulletVelocities.push_back(bullet.velocity);
+			Move(bullet, dt);
+		}
+	}
+
+	// Only the ships and bullets the broadphase pairs with an asteroid's path are tested against it
+	broadphase->Clear();
+	for (size_t i = 0; i < asteroids.size(); ++i)
+	{
+		broadphase->Add(asteroidIDs[i], static_cast<uint32_t>(i), GetSweptBox(asteroidBoxes[i], asteroids[i].velocity, dt), true);
+	}
+	for (size_t i = 0; i < shipBoxes.size(); ++i)
+	{
+		PlayerData const& player = playerDataMap[shipPorts[i]];
+		if (IsShipActive(shipPorts[i], player))
+			broadphase->Add(SHIP_BROADPHASE_KEY + shipPorts[i], static_cast<uint32_t>(i),
+							GetSweptBox(shipBoxes[i], player.transform.velocity, dt), false);
+	}
+	for (size_t i = 0; i < bulletBoxes.size(); ++i)
+	{
+		broadphase->Add(BULLET_BROADPHASE_KEY + static_cast<uint32_t>(i), static_cast<uint32_t>(shipBoxes.size() + i),
+						GetSweptBox(bulletBoxes[i], bulletVelocities[i], dt), false);
+	}
+	broadphase->FindPairs();
+
+	// An asteroid is destroyed by the first ship or bullet it hits
+	asteroidHit.assign(asteroids.size(), false);
+	bulletHit.assign(bulletBoxes.size(), false);
+	for (size_t i = 0; i < asteroids.size(); ++i)
+	{
+		// Ships out of the game and bullets already used are left out, the rest are tested at once
+		broadphase->GetCandidates(static_cast<uint32_t>(i), candidates);
+		if (candidates.empty())
+			continue;
+
+		testedCandidates.clear();
+		candidateBoxes.Clear();
+		for (uint32_t candidate : candidates)
+		{
+			if (candidate < shipBoxes.size())
+			{
+				PlayerData const& player = playerDataMap[shipPorts[candidate]];
+				if (!IsShipActive(shipPorts[candidate], player))
+					continue;
+				candidateBoxes.Add(shipBoxes[candidate], player.transform.velocity);
+			}
+			else
+			{
+				size_t bullet = candidate - shipBoxes.size();
+				if (bulletHit[bullet])
+					continue;
+				candidateBoxes.Add(bulletBoxes[bullet], bulletVelocities[bullet]);
+			}
+			testedCandidates.push_back(candidate);
+		}
+
+		candidateTimes.resize(candidateBoxes.Size());
+		if (CollisionIntersection_RectRectBatch(asteroidBoxes[i], asteroids[i].velocity, candidateBoxes, candidateTimes.data(), dt) == 0)
+			continue;
+
+		size_t hit = 0;
+		while (candidateTimes[hit] == COLLISION_NONE)
+			++hit;
+
+		uint32_t candidate = testedCandidates[hit];
+		if (candidate < shipBoxes.size())
+			HitShip(candidate);
+		else
+			HitBullet(candidate - shipBoxes.size());
+		asteroidHit[i] = true;
+	}
+
+	// Remove what was destroyed, keeping the order of the rest
+	size_t kept = 0;
+	for (size_t i = 0; i < asteroids.size(); ++i)
+	{
+		if (asteroidHit[i])
+			continue;
+		asteroids[kept] = asteroids[i];
+		asteroidIDs[kept++] = asteroidIDs[i];
+	}
+	asteroids.resize(kept);
+	asteroidIDs.resize(kept);
+
+	size_t bullet = 0;
+	for (auto& [portID, player] : playerDataMap)
+	{
+		std::vector<NetworkTransform>& bullets = playerBulletMap[portID];
+		kept = 0;
+		for (size_t i = 0; i < bullets.size(); ++i)
+		{
+			if (!bulletHit[bullet++] && !IsOutOfBounds(bullets[i]))
+				bullets[kept++] = bullets[i];
+		}
+		bullets.resize(kept);
+	}
+
+	// Wrap asteroids from one end of the screen to the other, ships already wrapped as they moved
+	for (NetworkTransform& asteroid : asteroids)
+	{
+		WrapPosition(asteroid, asteroid.scale);
+	}
+
+	for (; pendingAsteroids > 0; --pendingAsteroids)
+	{
+		SpawnRandomAsteroid();
+	}
+}
+
+void WriteSimulationState(NetworkGameState& gameState)
+{
+	std::lock_guard<std::mutex> lock(gameDataMutex);
+
+	gameState.playerCount = 0;
+	gameState.objectCount = 0;
+	for (auto& [portID, player] : playerDataMap)
+	{
+		if (gameState.playerCount < MAX_PLAYERS)
+			gameState.playerData[gameState.playerCount++] = player.stats;
+		if (IsShipActive(portID, player))
+			AddObject(gameState, ObjectType::OBJ_SHIP, portID, player.transform);
+	}
+
+	AddObject(gameState, ObjectType::OBJ_WALL, 0, wall);
+	for (size_t i = 0; i < asteroids.size(); ++i)
+	{
+		AddObject(gameState, ObjectType::OBJ_ASTEROID, asteroidIDs[i], asteroids[i]);
+	}
+	for (auto& [portID, player] : playerDataMap)
+	{
+		for (NetworkTransform const& bullet : playerBulletMap[portID])
+		{
+			AddObject(gameState, ObjectType::OBJ_BULLET, portID, bullet);
+		}
+	}
+}
@@ -0,0 +1,50 @@
+/******************************************************************************/
+/*!
+\file		ServerSimulation.h
+\author
+\par
+\date
+\brief		This file declares the authoritative simulation run by the server.
+			The world moves in fixed steps, so every run with the same inputs
+			gives the same result whatever the rate the server wakes at.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef SERVER_SIMULATION
+#define SERVER_SIMULATION // header guard
+
+#include "NetworkGameState.h"		// NetworkGameState
+
+#include <cstdint>					// uint32_t, uint64_t
+
+#define SIMULATION_TICK_RATE		60			// default steps per second, see serverTickRate in the configuration
+#define SIMULATION_MIN_TICK_RATE	10
+#define SIMULATION_MAX_TICK_RATE	240
+#define SIMULATION_MAX_STEPS		8			// steps one update runs at most, the rest is dropped if the server falls behind
+#define SIMULATION_SEED				0x2161A4u	// seed of the asteroids spawned during the game
+#define SIMULATION_MAX_BULLETS		32			// bullets alive per ship, older ones are replaced
+#define SHIP_INITIAL_LIVES			3
+
+// Steps per second of the simulation, read from the configuration by StartServer
+extern uint32_t simulationTickRate;
+
+// Function to create the world for the players in playerDataMap. The first step is due at now
+void InitSimulation(uint64_t now);
+
+// Function to run every step due by now, with the inputs held at the time of the call
+void UpdateSimulation(uint64_t now);
+
+// Function to get the time the next step is due
+uint64_t GetNextSimulationStep();
+
+// Function to run a single step of dt seconds
+void StepSimulation(float dt);
+
+// Function to copy the world into the game state sent to the clients
+void WriteSimulationState(NetworkGameState& gameState);
+
+#endif
@@ -0,0 +1,102 @@
+/******************************************************************************/
+/*!
+\file		ShipMovement.cpp
+\author
+\par
+\date
+\brief		This file defines the movement rules shared by the server
+			simulation and the client prediction. They follow the single
+			player game state, with time passed in instead of the frame time.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "ShipMovement.h"
+
+#include <cmath>					// cosf, sinf, sqrtf
+#include <algorithm>				// std::min, std::max
+
+static float Wrap(float x, float x0, float x1)
+{
+	if (x < x0)
+		return x + (x1 - x0);
+	if (x >= x1)
+		return x - (x1 - x0);
+	return x;
+}
+
+// Accelerates the ship along its direction, then applies the deceleration and the speed limit
+static void Thrust(NetworkTransform& ship, float acceleration, float maxSpeed, float dt)
+{
+	ship.velocity.x += acceleration * dt * cosf(ship.rotation);
+	ship.velocity.y += acceleration * dt * sinf(ship.rotation);
+
+	float speed = sqrtf(ship.velocity.x * ship.velocity.x + ship.velocity.y * ship.velocity.y);
+	if (speed > 0.0f)
+	{
+		float limited = (std::min)((std::max)(0.0f, speed - SHIP_DECCEL * dt), maxSpeed);
+		ship.velocity.x *= limited / speed;
+		ship.velocity.y *= limited / speed;
+	}
+}
+
+// Stops the ship where it touches the wall, only checked while it moves towards the wall
+static void CollideWithWall(NetworkTransform& ship, AEVec2 const& previous, AABB const& shipBox, float dt)
+{
+	static NetworkTransform const wall(AEVec2{ WALL_POSITION_X, WALL_POSITION_Y }, AEVec2{ 0, 0 }, 0.0f,
+									   AEVec2{ WALL_SCALE_X, WALL_SCALE_Y });
+	AABB wallBox = GetBoundingBox(wall);
+	AEVec2 toMin{ previous.x - wallBox.min.x, previous.y - wallBox.min.y };
+	AEVec2 toMax{ previous.x - wallBox.max.x, previous.y - wallBox.max.y };
+
+	bool approaching =
+		(toMin.y <= 0.0f && ship.velocity.y >= 0.0f) ||	// below the wall, moving up
+		(toMax.x >= 0.0f && ship.velocity.x <= 0.0f) ||	// right of the wall, moving left
+		(toMax.y >= 0.0f && ship.velocity.y <= 0.0f) ||	// above the wall, moving down
+		(toMin.x <= 0.0f && ship.velocity.x >= 0.0f);	// left of the wall, moving right
+
+	float firstTimeOfCollision = 0.0f;
+	if (approaching && CollisionIntersection_RectRect(shipBox, ship.velocity, wallBox, wall.velocity, firstTimeOfCollision, dt))
+	{
+		ship.position.x = ship.velocity.x * firstTimeOfCollision + previous.x;
+		ship.position.y = ship.velocity.y * firstTimeOfCollision + previous.y;
+		ship.velocity = { 0, 0 };
+	}
+}
+
+AABB GetBoundingBox(NetworkTransform const& transform)
+{
+	AEVec2 half{ BOUNDING_RECT_SIZE / 2.0f * transform.scale.x, BOUNDING_RECT_SIZE / 2.0f * transform.scale.y };
+	return AABB{ { transform.position.x - half.x, transform.position.y - half.y },
+				 { transform.position.x + half.x, transform.position.y + half.y } };
+}
+
+void WrapPosition(NetworkTransform& transform, AEVec2 const& margin)
+{
+	transform.position.x = Wrap(transform.position.x, -SCREEN_SIZE_X * 0.5f - margin.x, SCREEN_SIZE_X * 0.5f + margin.x);
+	transform.position.y = Wrap(transform.position.y, -SCREEN_SIZE_Y * 0.5f - margin.y, SCREEN_SIZE_Y * 0.5f + margin.y);
+}
+
+void MoveShip(NetworkTransform& ship, PlayerInput const& input, float dt)
+{
+	if (input.upKey)
+		Thrust(ship, SHIP_ACCEL_FORWARD, SHIP_MAX_SPEED_FORWARD, dt);
+	if (input.downKey)
+		Thrust(ship, -SHIP_ACCEL_BACKWARD, SHIP_MAX_SPEED_BACKWARD, dt);
+	if (input.leftKey)
+		ship.rotation = Wrap(ship.rotation + SHIP_ROT_SPEED * dt, -PI, PI);
+	if (input.rightKey)
+		ship.rotation = Wrap(ship.rotation - SHIP_ROT_SPEED * dt, -PI, PI);
+
+	AEVec2 previous = ship.position;
+	AABB shipBox = GetBoundingBox(ship);
+	ship.position.x += ship.velocity.x * dt;
+	ship.position.y += ship.velocity.y * dt;
+
+	CollideWithWall(ship, previous, shipBox, dt);
+	WrapPosition(ship, AEVec2{ SHIP_SCALE_X, SHIP_SCALE_Y });
+}
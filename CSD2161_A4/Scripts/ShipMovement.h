@@ -0,0 +1,33 @@
+/******************************************************************************/
+/*!
+\file		ShipMovement.h
+\author
+\par
+\date
+\brief		This file declares the movement rules shared by the server
+			simulation and the client prediction, so both move a ship the
+			same way for the same inputs.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef SHIP_MOVEMENT
+#define SHIP_MOVEMENT // header guard
+
+#include "GameData.h"				// PlayerInput, NetworkTransform
+#include "Collision.h"				// AABB
+
+// Function to get the bounding box of the transform at its current position
+AABB GetBoundingBox(NetworkTransform const& transform);
+
+// Function to wrap the transform from one end of the screen to the other, margin outside of it
+void WrapPosition(NetworkTransform& transform, AEVec2 const& margin);
+
+// Function to steer the ship with the keys held and move it over dt seconds. The ship stops where
+// it touches the wall, then wraps around the screen
+void MoveShip(NetworkTransform& ship, PlayerInput const& input, float dt);
+
+#endif
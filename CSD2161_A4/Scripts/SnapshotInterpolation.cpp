@@ -0,0 +1,250 @@
+/******************************************************************************/
+/*!
+\file		SnapshotInterpolation.cpp
+\author
+\par
+\date
+\brief		This file defines the jitter buffer of the client. The server
+			takes a snapshot every SNAPSHOT_INTERVAL_MS, so the sequence
+			number gives the server time of each snapshot. The delay the
+			world is drawn at follows how late and how often they arrive.
+			Every snapshot reaches the drawing thread through a queue, so
+			the arrival times of those received between two frames are
+			counted too. The rest of the state is only used by that thread.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "SnapshotInterpolation.h"
+
+#include "NetworkSnapshot.h"		// SNAPSHOT_INTERVAL_MS, CopyGameState
+#include "SequenceBuffer.h"			// SequenceBuffer
+#include "ShipMovement.h"			// WrapPosition
+#include "SpscQueue.h"				// SpscQueue
+
+#include <atomic>					// std::atomic
+#include <cmath>					// std::fabs
+#include <algorithm>				// std::clamp, std::min
+
+struct ReceivedSnapshot
+{
+	NetworkGameState state;
+	uint64_t receiveTime;
+	uint32_t game;							// snapshots of an earlier game are dropped
+};
+
+static SpscQueue<ReceivedSnapshot, INTERPOLATION_QUEUE_SIZE> receivedSnapshots;	// pushed by the receive thread, popped by the drawing thread
+static std::atomic<uint32_t> currentGame{ 0 };
+static uint32_t bufferedGame = 0;			// game of the snapshots kept
+
+static SequenceBuffer<NetworkGameState, INTERPOLATION_BUFFER_SIZE> snapshots;
+static uint32_t newestSequence;
+static bool hasSnapshot = false;
+
+static double clockOffset;					// average of arrival time - server time
+static double arrivalJitter;				// average distance of an arrival from clockOffset
+static double snapshotInterval;				// average server time between two snapshots received
+static double delay;						// time the world is drawn behind the newest snapshot expected
+
+static double GetServerTime(uint32_t sequence)
+{
+	return static_cast<double>(sequence) * SNAPSHOT_INTERVAL_MS;
+}
+
+static double GetTargetDelay()
+{
+	// One interval so the next snapshot is there before it is needed, and room for it to be late
+	return std::clamp(snapshotInterval + INTERPOLATION_JITTER_MULTIPLIER * arrivalJitter,
+					  static_cast<double>(INTERPOLATION_MIN_DELAY_MS), static_cast<double>(INTERPOLATION_MAX_DELAY_MS));
+}
+
+// Finds the object in the other snapshot. Asteroids and ships have their own identifiers, other
+// objects only match at the same index
+static NetworkObject const* FindObject(NetworkGameState const& state, uint32_t index, NetworkObject const& object)
+{
+	auto matches = [&object](NetworkObject const& other)
+	{
+		return other.type == object.type && other.identifier == object.identifier;
+	};
+
+	if (index < state.objectCount && matches(state.objects[index]))
+		return &state.objects[index];
+	if (object.type != ObjectType::OBJ_SHIP && object.type != ObjectType::OBJ_ASTEROID)
+		return nullptr;
+
+	for (uint32_t i = 0; i < state.objectCount; ++i)
+	{
+		if (matches(state.objects[i]))
+			return &state.objects[i];
+	}
+	return nullptr;
+}
+
+static float GetAngleBetween(float from, float to)
+{
+	float angle = to - from;
+	if (angle > PI)
+		angle -= 2.0f * PI;
+	else if (angle < -PI)
+		angle += 2.0f * PI;
+	return angle;
+}
+
+// Blends from the older transform into the newer one, kept as it is when the object jumped
+static void Blend(NetworkTransform& transform, NetworkTransform const& from, float alpha)
+{
+	float dx = transform.position.x - from.position.x;
+	float dy = transform.position.y - from.position.y;
+	if (dx * dx + dy * dy > INTERPOLATION_SNAP_DISTANCE * INTERPOLATION_SNAP_DISTANCE)
+	{
+		if (alpha < 0.5f)
+			transform = from;
+		return;
+	}
+
+	transform.position.x = from.position.x + dx * alpha;
+	transform.position.y = from.position.y + dy * alpha;
+	transform.velocity.x = from.velocity.x + (transform.velocity.x - from.velocity.x) * alpha;
+	transform.velocity.y = from.velocity.y + (transform.velocity.y - from.velocity.y) * alpha;
+	transform.rotation = from.rotation + GetAngleBetween(from.rotation, transform.rotation) * alpha;
+}
+
+// Moves the object along its velocity, wrapping the way the server does
+static void Extrapolate(NetworkObject& object, float seconds)
+{
+	object.transform.position.x += object.transform.velocity.x * seconds;
+	object.transform.position.y += object.transform.velocity.y * seconds;
+	if (object.type == ObjectType::OBJ_SHIP)
+		WrapPosition(object.transform, AEVec2{ SHIP_SCALE_X, SHIP_SCALE_Y });
+	else if (object.type == ObjectType::OBJ_ASTEROID)
+		WrapPosition(object.transform, object.transform.scale);
+}
+
+// Keeps a snapshot taken from the queue and updates the delay with its arrival time
+static void AddSnapshot(NetworkGameState const& snapshot, uint64_t receiveTime)
+{
+	uint32_t sequence = snapshot.sequenceNumber;
+	double offset = static_cast<double>(receiveTime) - GetServerTime(sequence);
+	if (!hasSnapshot)
+	{
+		newestSequence = sequence;
+		clockOffset = offset;
+		arrivalJitter = 0.0;
+		snapshotInterval = SNAPSHOT_INTERVAL_MS;
+		delay = GetTargetDelay();
+		hasSnapshot = true;
+	}
+	else if (static_cast<int32_t>(sequence - newestSequence) > 0)
+	{
+		snapshotInterval += (GetServerTime(sequence - newestSequence) - snapshotInterval) * INTERPOLATION_SMOOTHING;
+		newestSequence = sequence;
+	}
+	else if (static_cast<int32_t>(newestSequence - sequence) >= INTERPOLATION_BUFFER_SIZE)
+	{
+		return; // too old, its slot holds a newer snapshot
+	}
+
+	// Late arrivals also count, they are what the delay has to cover
+	arrivalJitter += (std::fabs(offset - clockOffset) - arrivalJitter) * INTERPOLATION_SMOOTHING;
+	clockOffset += (offset - clockOffset) * INTERPOLATION_SMOOTHING;
+	delay += (GetTargetDelay() - delay) * INTERPOLATION_SMOOTHING;
+
+	CopyGameState(snapshots.Insert(sequence), snapshot);
+}
+
+void ResetInterpolation()
+{
+	currentGame.fetch_add(1, std::memory_order_release);
+}
+
+void PushInterpolationSnapshot(NetworkGameState const& snapshot, uint64_t receiveTime)
+{
+	ReceivedSnapshot* received = receivedSnapshots.GetWriteSlot();
+	if (received == nullptr)
+		return;
+
+	CopyGameState(received->state, snapshot);
+	received->receiveTime = receiveTime;
+	received->game = currentGame.load(std::memory_order_acquire);
+	receivedSnapshots.Commit();
+}
+
+bool SampleInterpolation(NetworkGameState& state, uint64_t now)
+{
+	uint32_t game = currentGame.load(std::memory_order_acquire);
+	if (game != bufferedGame)
+	{
+		snapshots.Clear();
+		hasSnapshot = false;
+		bufferedGame = game;
+	}
+
+	// Every snapshot pushed since the last frame, oldest first
+	for (ReceivedSnapshot const* received = receivedSnapshots.Peek(); received != nullptr; received = receivedSnapshots.Peek())
+	{
+		if (received->game == bufferedGame)
+			AddSnapshot(received->state, received->receiveTime);
+		receivedSnapshots.Release();
+	}
+	if (!hasSnapshot)
+		return false;
+
+	// Newest snapshot at or before the time drawn, and the oldest one after it
+	double time = static_cast<double>(now) - clockOffset - delay;
+	NetworkGameState const* before = nullptr;
+	NetworkGameState const* after = nullptr;
+	for (uint32_t i = 0; i < INTERPOLATION_BUFFER_SIZE; ++i)
+	{
+		NetworkGameState const* snapshot = snapshots.Find(newestSequence - i);
+		if (snapshot == nullptr)
+			continue;
+		if (GetServerTime(snapshot->sequenceNumber) <= time)
+		{
+			before = snapshot;
+			break;
+		}
+		after = snapshot;
+	}
+
+	if (before == nullptr)
+	{
+		// Drawing earlier than anything kept, eg. right after joining
+		CopyGameState(state, *after);
+		return true;
+	}
+	if (after == nullptr)
+	{
+		// Buffer ran dry, carry on along the velocities for a while
+		CopyGameState(state, *before);
+		double ahead = (std::min)(time - GetServerTime(before->sequenceNumber), static_cast<double>(INTERPOLATION_MAX_EXTRAPOLATION_MS));
+		for (uint32_t i = 0; i < state.objectCount; ++i)
+		{
+			Extrapolate(state.objects[i], static_cast<float>(ahead / 1000.0));
+		}
+		return true;
+	}
+
+	// Objects only in the newer snapshot were created in between and are shown as they are.
+	// Bullets fly straight, so they are placed from their velocity instead
+	CopyGameState(state, *after);
+	double afterTime = GetServerTime(after->sequenceNumber);
+	double beforeTime = GetServerTime(before->sequenceNumber);
+	float alpha = static_cast<float>((time - beforeTime) / (afterTime - beforeTime));
+	for (uint32_t i = 0; i < state.objectCount; ++i)
+	{
+		NetworkObject& object = state.objects[i];
+		if (object.type == ObjectType::OBJ_BULLET)
+		{
+			Extrapolate(object, static_cast<float>((time - afterTime) / 1000.0));
+		}
+		else if (NetworkObject const* from = FindObject(*before, i, object))
+		{
+			Blend(object.transform, from->transform, alpha);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,44 @@
+/******************************************************************************/
+/*!
+\file		SnapshotInterpolation.h
+\author
+\par
+\date
+\brief		This file declares the jitter buffer of the client. Complete
+			snapshots are kept with the time they arrived, and the world is
+			drawn a little in the past so there is a snapshot on each side of
+			the time shown.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef SNAPSHOT_INTERPOLATION
+#define SNAPSHOT_INTERPOLATION // header guard
+
+#include "NetworkGameState.h"		// NetworkGameState
+
+#define INTERPOLATION_BUFFER_SIZE			32			// snapshots kept, ~0.5 s of server time
+#define INTERPOLATION_QUEUE_SIZE			8			// snapshots received and not yet taken by the drawing thread
+#define INTERPOLATION_MIN_DELAY_MS			32			// shortest delay the world is drawn at
+#define INTERPOLATION_MAX_DELAY_MS			250			// longest delay, more jitter than this is extrapolated
+#define INTERPOLATION_JITTER_MULTIPLIER		2.0f		// deviations of the arrival time covered by the delay
+#define INTERPOLATION_SMOOTHING				0.1f		// weight of a new arrival in the averages
+#define INTERPOLATION_MAX_EXTRAPOLATION_MS	200			// objects stop moving this long after the newest snapshot
+#define INTERPOLATION_SNAP_DISTANCE			128.0f		// larger moves are not blended, eg. wrapping around the screen
+
+// Function to empty the buffer when a new game starts
+void ResetInterpolation();
+
+// Function to add a complete snapshot that arrived at receiveTime, from GetTimeNow. Called by the
+// receive thread only, it never waits for the drawing thread and drops the snapshot if the queue is full
+void PushInterpolationSnapshot(NetworkGameState const& snapshot, uint64_t receiveTime);
+
+// Function to get the world to draw at time now. Objects are blended between the snapshots on each
+// side of the delayed time, or moved along their velocity when the newest one is too old.
+// Called by the drawing thread only. Returns false until a snapshot arrived
+bool SampleInterpolation(NetworkGameState& state, uint64_t now);
+
+#endif
@@ -0,0 +1,65 @@
+/******************************************************************************/
+/*!
+\file		SpscQueue.h
+\author
+\par
+\date
+\brief		This file declares a fixed capacity lock-free queue between one
+			producer thread and one consumer thread. The server's event loop
+			holds the packets of each client in one until the next
+			simulation step, and the client hands complete snapshots from
+			its receive thread to the drawing thread through another.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef SPSC_QUEUE
+#define SPSC_QUEUE // header guard
+
+#include <atomic>					// std::atomic
+#include <cstddef>					// size_t
+
+// Ring of Capacity slots. Only the producer moves the tail and only the consumer moves the head,
+// so neither side ever blocks the other. One slot is kept free to tell a full ring from an empty one
+template <typename TItem, size_t Capacity>
+class SpscQueue
+{
+public:
+	SpscQueue();
+
+	// Called by the producer only. Returns false, dropping the item, if the queue is full
+	bool Push(TItem const& item);
+
+	// Called by the consumer only. Returns false if the queue is empty
+	bool Pop(TItem& item);
+
+	// Called by the producer only. Returns the slot of the next item to fill in place, or nullptr if
+	// the queue is full. The consumer sees the item once Commit is called
+	TItem* GetWriteSlot();
+	void Commit();
+
+	// Called by the consumer only. Returns the oldest item to read in place, or nullptr if the queue
+	// is empty. Release hands its slot back to the producer
+	TItem const* Peek() const;
+	void Release();
+
+	bool IsEmpty() const;
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+private:
+	static size_t GetNext(size_t index);
+
+	// Kept on separate cache lines so the two threads do not invalidate each other's
+	alignas(64) std::atomic<size_t> _head;		// next slot to pop
+	alignas(64) std::atomic<size_t> _tail;		// next slot to push
+	TItem _items[Capacity];
+};
+
+#include "SpscQueue.hpp"
+
+#endif
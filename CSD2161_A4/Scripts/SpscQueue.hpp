@@ -0,0 +1,99 @@
+/******************************************************************************/
+/*!
+\file		SpscQueue.hpp
+\author
+\par
+\date
+\brief		This file contains the definitions of the lock-free queue between
+			one producer thread and one consumer thread.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP // header guard
+
+#include "SpscQueue.h"
+
+template <typename TItem, size_t Capacity>
+SpscQueue<TItem, Capacity>::SpscQueue() :
+	_head{ 0 },
+	_tail{ 0 }
+{
+}
+
+template <typename TItem, size_t Capacity>
+size_t SpscQueue<TItem, Capacity>::GetNext(size_t index)
+{
+	return (index + 1) % Capacity;
+}
+
+template <typename TItem, size_t Capacity>
+bool SpscQueue<TItem, Capacity>::Push(TItem const& item)
+{
+	size_t tail = _tail.load(std::memory_order_relaxed);
+	size_t next = GetNext(tail);
+	if (next == _head.load(std::memory_order_acquire))
+		return false;
+
+	_items[tail] = item;
+
+	// Publishes the item to the consumer
+	_tail.store(next, std::memory_order_release);
+	return true;
+}
+
+template <typename TItem, size_t Capacity>
+bool SpscQueue<TItem, Capacity>::Pop(TItem& item)
+{
+	size_t head = _head.load(std::memory_order_relaxed);
+	if (head == _tail.load(std::memory_order_acquire))
+		return false;
+
+	item = _items[head];
+
+	// Hands the slot back to the producer
+	_head.store(GetNext(head), std::memory_order_release);
+	return true;
+}
+
+template <typename TItem, size_t Capacity>
+TItem* SpscQueue<TItem, Capacity>::GetWriteSlot()
+{
+	size_t tail = _tail.load(std::memory_order_relaxed);
+	if (GetNext(tail) == _head.load(std::memory_order_acquire))
+		return nullptr;
+	return &_items[tail];
+}
+
+template <typename TItem, size_t Capacity>
+void SpscQueue<TItem, Capacity>::Commit()
+{
+	_tail.store(GetNext(_tail.load(std::memory_order_relaxed)), std::memory_order_release);
+}
+
+template <typename TItem, size_t Capacity>
+TItem const* SpscQueue<TItem, Capacity>::Peek() const
+{
+	size_t head = _head.load(std::memory_order_relaxed);
+	if (head == _tail.load(std::memory_order_acquire))
+		return nullptr;
+	return &_items[head];
+}
+
+template <typename TItem, size_t Capacity>
+void SpscQueue<TItem, Capacity>::Release()
+{
+	_head.store(GetNext(_head.load(std::memory_order_relaxed)), std::memory_order_release);
+}
+
+template <typename TItem, size_t Capacity>
+bool SpscQueue<TItem, Capacity>::IsEmpty() const
+{
+	return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+}
+
+#endif
@@ -0,0 +1,162 @@
+/******************************************************************************/
+/*!
+\file		SweepAndPrune.cpp
+\author
+\par
+\date
+\brief		This file defines the sweep and prune broadphase.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+// Main header
+#include "SweepAndPrune.h"
+
+#include <algorithm>				// std::sort, std::equal_range
+
+// Edges at the same place keep the left one first, so boxes touching there are still paired
+static bool IsBefore(float value, bool isMin, float otherValue, bool otherIsMin)
+{
+	return value < otherValue || (value == otherValue && isMin && !otherIsMin);
+}
+
+SweepAndPrune::SweepAndPrune() : _step{ 0 }
+{
+}
+
+void SweepAndPrune::Clear()
+{
+	++_step;
+}
+
+void SweepAndPrune::Add(uint32_t key, uint32_t index, AABB const& box, bool isAsteroid)
+{
+	auto found = _proxyOfKey.find(key);
+	uint32_t proxy;
+	if (found != _proxyOfKey.end())
+	{
+		proxy = found->second;
+	}
+	else
+	{
+		if (_freeProxies.empty())
+		{
+			proxy = static_cast<uint32_t>(_proxies.size());
+			_proxies.emplace_back();
+		}
+		else
+		{
+			proxy = _freeProxies.back();
+			_freeProxies.pop_back();
+		}
+		_proxyOfKey.emplace(key, proxy);
+
+		// New edges start at the end of the list, the sort moves them to their place
+		_endpoints.push_back(Endpoint{ box.min.x, proxy, true });
+		_endpoints.push_back(Endpoint{ box.max.x, proxy, false });
+	}
+
+	_proxies[proxy] = Proxy{ box, key, index, _step, 0, isAsteroid };
+}
+
+void SweepAndPrune::RemoveStaleProxies()
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < _endpoints.size(); ++i)
+	{
+		Endpoint const& endpoint = _endpoints[i];
+		Proxy const& proxy = _proxies[endpoint.proxy];
+		if (proxy.step == _step)
+		{
+			_endpoints[kept++] = endpoint;
+		}
+		else if (endpoint.isMin)
+		{
+			_proxyOfKey.erase(proxy.key);
+			_freeProxies.push_back(endpoint.proxy);
+		}
+	}
+	_endpoints.resize(kept);
+}
+
+void SweepAndPrune::SortEndpoints()
+{
+	for (Endpoint& endpoint : _endpoints)
+	{
+		AABB const& box = _proxies[endpoint.proxy].box;
+		endpoint.value = endpoint.isMin ? box.min.x : box.max.x;
+	}
+
+	for (size_t i = 1; i < _endpoints.size(); ++i)
+	{
+		Endpoint endpoint = _endpoints[i];
+		size_t j = i;
+		for (; j > 0 && IsBefore(endpoint.value, endpoint.isMin, _endpoints[j - 1].value, _endpoints[j - 1].isMin); --j)
+		{
+			_endpoints[j] = _endpoints[j - 1];
+		}
+		_endpoints[j] = endpoint;
+	}
+}
+
+void SweepAndPrune::FindPairs()
+{
+	RemoveStaleProxies();
+	SortEndpoints();
+
+	// Going right, a box is paired with the boxes of the other kind it starts inside of
+	_pairs.clear();
+	_activeAsteroids.clear();
+	_activeOthers.clear();
+	for (Endpoint const& endpoint : _endpoints)
+	{
+		Proxy& proxy = _proxies[endpoint.proxy];
+		std::vector<uint32_t>& active = proxy.isAsteroid ? _activeAsteroids : _activeOthers;
+		if (!endpoint.isMin)
+		{
+			// Swap with the last one, the order of the boxes crossing the sweep does not matter
+			uint32_t last = active.back();
+			active[proxy.active] = last;
+			_proxies[last].active = proxy.active;
+			active.pop_back();
+			continue;
+		}
+
+		for (uint32_t other : proxy.isAsteroid ? _activeOthers : _activeAsteroids)
+		{
+			AABB const& box = _proxies[other].box;
+			if (proxy.box.min.y > box.max.y || box.min.y > proxy.box.max.y)
+				continue;
+
+			if (proxy.isAsteroid)
+				_pairs.push_back(Pair{ proxy.index, _proxies[other].index });
+			else
+				_pairs.push_back(Pair{ _proxies[other].index, proxy.index });
+		}
+
+		proxy.active = static_cast<uint32_t>(active.size());
+		active.push_back(endpoint.proxy);
+	}
+
+	std::sort(_pairs.begin(), _pairs.end(), [](Pair const& left, Pair const& right)
+	{
+		return left.asteroid < right.asteroid || (left.asteroid == right.asteroid && left.other < right.other);
+	});
+}
+
+void SweepAndPrune::GetCandidates(uint32_t asteroid, std::vector<uint32_t>& found)
+{
+	found.clear();
+
+	auto range = std::equal_range(_pairs.begin(), _pairs.end(), Pair{ asteroid, 0 }, [](Pair const& left, Pair const& right)
+	{
+		return left.asteroid < right.asteroid;
+	});
+	for (auto pair = range.first; pair != range.second; ++pair)
+	{
+		found.push_back(pair->other);
+	}
+}
@@ -0,0 +1,84 @@
+/******************************************************************************/
+/*!
+\file		SweepAndPrune.h
+\author
+\par
+\date
+\brief		This file declares the sweep and prune broadphase. The left and
+			right edges of every box are kept in one list sorted along x,
+			which is swept to find the boxes overlapping on x before their
+			y is compared.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef SWEEP_AND_PRUNE_H
+#define SWEEP_AND_PRUNE_H // header guard
+
+#include "CollisionBroadphase.h"	// CollisionBroadphase
+
+#include <unordered_map>			// std::unordered_map
+
+// The list of edges is kept from step to step. Objects move little in a step, so it is almost
+// sorted already and an insertion sort puts it back in order in close to linear time. Keys that
+// follow an object keep it that way, a key given to another object only costs sorting time
+class SweepAndPrune : public CollisionBroadphase
+{
+public:
+	SweepAndPrune();
+
+	// Starts a step, the edges of the objects not added again are removed by FindPairs
+	void Clear() override;
+
+	// Adds the object of the key, or moves it if it was added in the last step
+	void Add(uint32_t key, uint32_t index, AABB const& box, bool isAsteroid) override;
+
+	// Sorts the edges and sweeps them, pairing each asteroid with the other objects it overlaps
+	void FindPairs() override;
+
+	void GetCandidates(uint32_t asteroid, std::vector<uint32_t>& found) override;
+
+private:
+	struct Proxy
+	{
+		AABB box;
+		uint32_t key;
+		uint32_t index;
+		uint32_t step;					// last step the object was added in
+		uint32_t active;				// position in its list of boxes crossing the sweep
+		bool isAsteroid;
+	};
+
+	struct Endpoint
+	{
+		float value;
+		uint32_t proxy;
+		bool isMin;
+	};
+
+	struct Pair
+	{
+		uint32_t asteroid;
+		uint32_t other;
+	};
+
+	// Removes the edges of the objects not added this step and frees their proxies
+	void RemoveStaleProxies();
+
+	// Takes the edges from the boxes of this step and sorts them again
+	void SortEndpoints();
+
+	std::unordered_map<uint32_t, uint32_t> _proxyOfKey;
+	std::vector<Proxy> _proxies;
+	std::vector<uint32_t> _freeProxies;
+	std::vector<Endpoint> _endpoints;	// left and right edge of every proxy, sorted along x
+	std::vector<uint32_t> _activeAsteroids;
+	std::vector<uint32_t> _activeOthers;
+	std::vector<Pair> _pairs;			// sorted by asteroid, then by other object
+	uint32_t _step;
+};
+
+#endif
@@ -0,0 +1,60 @@
+/******************************************************************************/
+/*!
+\file		TripleBuffer.h
+\author
+\par
+\date
+\brief		This file declares a lock-free handoff of the newest value from
+			one writer thread to one reader thread, used to pass received
+			game states to the thread drawing them.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef TRIPLE_BUFFER
+#define TRIPLE_BUFFER // header guard
+
+#include <atomic>					// std::atomic
+#include <cstdint>					// uint8_t
+
+// Three slots: the writer fills one, the reader reads another, and the third holds the newest value
+// published. Both sides swap their slot with the third one, so neither ever waits for the other and
+// the reader never sees a value being written. Values published before the reader took them are lost
+template <typename TValue>
+class TripleBuffer
+{
+public:
+	TripleBuffer();
+
+	// Called by the writer only. Returns the slot to fill, it keeps what was written to it before
+	TValue& GetWriteBuffer();
+
+	// Called by the writer only. Makes the filled slot the newest value
+	void Publish();
+
+	// Called by the reader only. Takes the newest value if one was published since the last call,
+	// returns false if the read buffer did not change
+	bool Update();
+
+	// Called by the reader only. Returns the value taken by the last Update
+	TValue const& GetReadBuffer() const;
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+private:
+	static constexpr uint8_t INDEX_MASK = 0x3;
+	static constexpr uint8_t FRESH = 0x4;		// set in _middle when the writer published after the reader's last swap
+
+	uint8_t _write;								// slot of the writer
+	uint8_t _read;								// slot of the reader
+	alignas(64) std::atomic<uint8_t> _middle;	// slot of the newest value and the FRESH flag
+	TValue _values[3];
+};
+
+#include "TripleBuffer.hpp"
+
+#endif
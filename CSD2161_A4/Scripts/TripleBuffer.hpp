@@ -0,0 +1,59 @@
+/******************************************************************************/
+/*!
+\file		TripleBuffer.hpp
+\author
+\par
+\date
+\brief		This file contains the definitions of the lock-free handoff of
+			the newest value between two threads.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP // header guard
+
+#include "TripleBuffer.h"
+
+template <typename TValue>
+TripleBuffer<TValue>::TripleBuffer() :
+	_write{ 0 },
+	_read{ 1 },
+	_middle{ 2 },
+	_values{}
+{
+}
+
+template <typename TValue>
+TValue& TripleBuffer<TValue>::GetWriteBuffer()
+{
+	return _values[_write];
+}
+
+template <typename TValue>
+void TripleBuffer<TValue>::Publish()
+{
+	// Releases the written slot to the reader and takes back whichever slot was in the middle
+	_write = _middle.exchange(static_cast<uint8_t>(_write | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+}
+
+template <typename TValue>
+bool TripleBuffer<TValue>::Update()
+{
+	if ((_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+		return false;
+
+	_read = _middle.exchange(_read, std::memory_order_acq_rel) & INDEX_MASK;
+	return true;
+}
+
+template <typename TValue>
+TValue const& TripleBuffer<TValue>::GetReadBuffer() const
+{
+	return _values[_read];
+}
+
+#endif
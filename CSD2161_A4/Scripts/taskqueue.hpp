@@ -6,8 +6,7 @@
 #define _TASKQUEUE_HPP_
 #include <optional>
 #include "taskqueue.h"
-//use for synch on stdout
-static std::mutex _stdoutMutex;
+#include "Logger.h"
 template <typename TItem, typename TAction, typename TOnDisconnect>
 TaskQueue<TItem, TAction, TOnDisconnect>::TaskQueue(size_t workerCount, size_t slotCount, TAction& action, TOnDisconnect& onDisconnect) :
 	_slotCount{ slotCount },
@@ -84,14 +83,7 @@ void TaskQueue<TItem, TAction, TOnDisconnect>::work(TaskQueue<TItem, TAction, TO
 {
 	while (true)
 	{
-		{
-			std::lock_guard<std::mutex> usersLock{ _stdoutMutex };
-			std::cout
-				<< "Thread ["
-				<< std::this_thread::get_id()
-				<< "] is waiting for a task."
-				<< std::endl;
-		}
+		LOG_DEBUG("Thread [" << std::this_thread::get_id() << "] is waiting for a task.");
 		std::optional<TItem> item = tq.consume();
 		if (!item)
 		{
@@ -99,14 +91,7 @@ void TaskQueue<TItem, TAction, TOnDisconnect>::work(TaskQueue<TItem, TAction, TO
 			break;
 		}
 
-		{
-			std::lock_guard<std::mutex> usersLock{ _stdoutMutex };
-			std::cout
-				<< "Thread ["
-				<< std::this_thread::get_id()
-				<< "] is executing a task."
-				<< std::endl;
-		}
+		LOG_DEBUG("Thread [" << std::this_thread::get_id() << "] is executing a task.");
 
 		if (!action(*item))
 		{
@@ -115,14 +100,7 @@ void TaskQueue<TItem, TAction, TOnDisconnect>::work(TaskQueue<TItem, TAction, TO
 		}
 	}
 
-	{
-		std::lock_guard<std::mutex> usersLock{ _stdoutMutex };
-		std::cout
-			<< "Thread ["
-			<< std::this_thread::get_id()
-			<< "] is exiting."
-			<< std::endl;
-	}
+	LOG_DEBUG("Thread [" << std::this_thread::get_id() << "] is exiting.");
 }
 
 template <typename TItem, typename TAction, typename TOnDisconnect>
@@ -0,0 +1,32 @@
+/******************************************************************************/
+/*!
+\file		Check.h
+\author
+\par
+\date
+\brief		This file declares the check used by the tests run with ctest.
+			A failed check is printed and makes the test return non-zero.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#ifndef CHECK_H
+#define CHECK_H // header guard
+
+#include <iostream>					// std::cerr
+
+// Failed checks of the test, main fails when there is any
+inline int checkFailures = 0;
+
+// Prints the condition and where it is the first few times it does not hold
+#define CHECK(condition)																	\
+	do																						\
+	{																						\
+		if (!(condition) && ++checkFailures <= 10)											\
+			std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n";	\
+	} while (false)
+
+#endif
@@ -0,0 +1,110 @@
+/******************************************************************************/
+/*!
+\file		CollisionBatchTest.cpp
+\author
+\par
+\date
+\brief		This file checks CollisionIntersection_RectRectBatch returns,
+			bit for bit, the times CollisionIntersection_RectRect finds for
+			each box of the batch. Batches of every size up to a few lanes
+			cover the boxes tested after the last full group of lanes.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#include "Check.h"					// CHECK, checkFailures
+
+#include "Collision.h"				// CollisionIntersection_RectRect, CollisionIntersection_RectRectBatch
+
+#include <cstdlib>					// EXIT_SUCCESS, EXIT_FAILURE
+#include <cstring>					// memcmp
+#include <random>					// std::mt19937
+#include <vector>					// std::vector
+
+#define MAX_BATCH_SIZE	23			// several groups of lanes and every remainder
+
+static std::mt19937 generator(2161);
+
+// Mostly random values, but often on a coarse grid so boxes touch and edges line up exactly
+static float GetValue(float min, float max)
+{
+	if (generator() % 6 == 0)
+		return static_cast<float>(static_cast<int>(generator() % 21) - 10) * 5.0f;
+	return std::uniform_real_distribution<float>(min, max)(generator);
+}
+
+static AABB GetBox()
+{
+	float x = GetValue(-100.0f, 100.0f);
+	float y = GetValue(-100.0f, 100.0f);
+	return AABB{ { x, y }, { x + GetValue(0.0f, 40.0f), y + GetValue(0.0f, 40.0f) } };
+}
+
+// Sometimes still, sometimes moving along with the other box on an axis
+static float GetSpeed(float other)
+{
+	switch (generator() % 6)
+	{
+	case 0:		return 0.0f;
+	case 1:		return other;
+	default:	return GetValue(-300.0f, 300.0f);
+	}
+}
+
+// Tests the box against the batch both ways and compares every lane
+static void CheckBatch(AABB const& box, AEVec2 const& velocity, AABBBatch const& batch, float dt)
+{
+	std::vector<float> times(batch.Size(), 123.0f);
+	size_t hits = CollisionIntersection_RectRectBatch(box, velocity, batch, times.data(), dt);
+
+	size_t expectedHits = 0;
+	for (size_t i = 0; i < batch.Size(); ++i)
+	{
+		AABB other{ { batch.minX[i], batch.minY[i] }, { batch.maxX[i], batch.maxY[i] } };
+		float time = 0.0f;
+		bool hit = CollisionIntersection_RectRect(box, velocity, other, AEVec2{ batch.velX[i], batch.velY[i] }, time, dt);
+		float expected = hit ? time : COLLISION_NONE;
+		expectedHits += hit ? 1 : 0;
+
+		CHECK(memcmp(&expected, &times[i], sizeof(float)) == 0);
+	}
+	CHECK(hits == expectedHits);
+}
+
+int main()
+{
+	AABBBatch batch;
+	for (int round = 0; round < 20000; ++round)
+	{
+		AABB box = GetBox();
+		AEVec2 velocity{ GetSpeed(0.0f), GetSpeed(0.0f) };
+
+		batch.Clear();
+		size_t size = round % (MAX_BATCH_SIZE + 1);
+		for (size_t i = 0; i < size; ++i)
+		{
+			batch.Add(GetBox(), AEVec2{ GetSpeed(velocity.x), GetSpeed(velocity.y) });
+		}
+
+		float dt = (generator() % 6 == 0) ? 0.0f : 0.05f + static_cast<float>(generator() % 100) / 100.0f;
+		CheckBatch(box, velocity, batch, dt);
+	}
+
+	// A box overlapping before moving is hit at time 0, in every lane and in the remainder
+	batch.Clear();
+	for (int i = 0; i < 7; ++i)
+	{
+		batch.Add(AABB{ { 0.0f, 0.0f }, { 10.0f, 10.0f } }, AEVec2{ 0.0f, 0.0f });
+	}
+	std::vector<float> times(batch.Size());
+	CHECK(CollisionIntersection_RectRectBatch(AABB{ { 5.0f, 5.0f }, { 15.0f, 15.0f } }, AEVec2{ 0.0f, 0.0f }, batch, times.data(), 0.016f) == 7);
+	for (float time : times)
+	{
+		CHECK(time == 0.0f);
+	}
+
+	return checkFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,174 @@
+/******************************************************************************/
+/*!
+\file		CollisionBroadphaseTest.cpp
+\author
+\par
+\date
+\brief		This file moves objects over many steps and checks the
+			candidates of each asteroid from both broadphases against a
+			test of every pair. Sweep and prune finds exactly the boxes that
+			overlap, the grid finds at least those. Objects come and go
+			between steps, as ships die and bullets are fired.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#include "Check.h"					// CHECK, checkFailures
+
+#include "CollisionBroadphase.h"	// CreateCollisionBroadphase
+
+#include <algorithm>				// std::includes, std::adjacent_find
+#include <cmath>					// std::floor
+#include <cstdlib>					// EXIT_SUCCESS, EXIT_FAILURE
+#include <functional>				// std::greater_equal
+#include <random>					// std::mt19937
+#include <vector>					// std::vector
+
+#define TEST_ASTEROIDS		30
+#define TEST_OTHERS			60		// ships and bullets
+#define TEST_STEPS			500
+#define TEST_STEP_SECONDS	0.016f
+
+struct TestObject
+{
+	AABB box;
+	AEVec2 velocity;
+};
+
+static std::mt19937 generator(2161);
+
+// Mostly random values, but often on a coarse grid so edges of different boxes line up exactly
+static float GetValue(float min, float max)
+{
+	float value = std::uniform_real_distribution<float>(min, max)(generator);
+	return (generator() % 4 == 0) ? std::floor(value / 16.0f) * 16.0f : value;
+}
+
+static TestObject GetObject(float maxSize, float maxSpeed)
+{
+	float x = GetValue(-460.0f, 460.0f);
+	float y = GetValue(-360.0f, 360.0f);
+	return TestObject{ AABB{ { x, y }, { x + GetValue(1.0f, maxSize), y + GetValue(1.0f, maxSize) } },
+					   AEVec2{ GetValue(-maxSpeed, maxSpeed), GetValue(-maxSpeed, maxSpeed) } };
+}
+
+// Boxes touching on an edge count as overlapping, as in both broadphases
+static bool IsOverlapping(AABB const& a, AABB const& b)
+{
+	return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+static void MoveObject(TestObject& object)
+{
+	float dx = object.velocity.x * TEST_STEP_SECONDS;
+	float dy = object.velocity.y * TEST_STEP_SECONDS;
+	object.box.min.x += dx;
+	object.box.max.x += dx;
+	object.box.min.y += dy;
+	object.box.max.y += dy;
+}
+
+// Increasing and each index once
+static bool IsStrictlyIncreasing(std::vector<uint32_t> const& found)
+{
+	return std::adjacent_find(found.begin(), found.end(), std::greater_equal<uint32_t>()) == found.end();
+}
+
+int main()
+{
+	std::vector<TestObject> asteroids, others;
+	for (int i = 0; i < TEST_ASTEROIDS; ++i)
+		asteroids.push_back(GetObject(120.0f, 200.0f));
+	for (int i = 0; i < TEST_OTHERS; ++i)
+		others.push_back(GetObject(24.0f, 600.0f));
+
+	std::unique_ptr<CollisionBroadphase> grid = CreateCollisionBroadphase(CollisionBroadphaseType::GRID);
+	std::unique_ptr<CollisionBroadphase> sweepAndPrune = CreateCollisionBroadphase(CollisionBroadphaseType::SWEEP_AND_PRUNE);
+
+	std::vector<AABB> asteroidBoxes, otherBoxes;
+	std::vector<uint32_t> expected, fromGrid, fromSweepAndPrune;
+	for (int step = 0; step < TEST_STEPS; ++step)
+	{
+		// Some objects sit a step out, and objects leaving the playfield come back elsewhere
+		asteroidBoxes.clear();
+		otherBoxes.clear();
+		grid->Clear();
+		sweepAndPrune->Clear();
+		for (uint32_t key = 0; key < asteroids.size(); ++key)
+		{
+			TestObject& asteroid = asteroids[key];
+			if (asteroid.box.min.x < -500.0f || asteroid.box.max.x > 500.0f || asteroid.box.min.y < -400.0f || asteroid.box.max.y > 400.0f)
+				asteroid = GetObject(120.0f, 200.0f);
+			if (generator() % 10 == 0)
+				continue;
+
+			AABB box = GetSweptBox(asteroid.box, asteroid.velocity, TEST_STEP_SECONDS);
+			uint32_t index = static_cast<uint32_t>(asteroidBoxes.size());
+			asteroidBoxes.push_back(box);
+			grid->Add(key, index, box, true);
+			sweepAndPrune->Add(key, index, box, true);
+		}
+		for (uint32_t key = 0; key < others.size(); ++key)
+		{
+			TestObject& other = others[key];
+			if (other.box.min.x < -500.0f || other.box.max.x > 500.0f || other.box.min.y < -400.0f || other.box.max.y > 400.0f)
+				other = GetObject(24.0f, 600.0f);
+			if (generator() % 4 == 0)
+				continue;
+
+			AABB box = GetSweptBox(other.box, other.velocity, TEST_STEP_SECONDS);
+			uint32_t index = static_cast<uint32_t>(otherBoxes.size());
+			otherBoxes.push_back(box);
+			grid->Add(TEST_ASTEROIDS + key, index, box, false);
+			sweepAndPrune->Add(TEST_ASTEROIDS + key, index, box, false);
+		}
+		grid->FindPairs();
+		sweepAndPrune->FindPairs();
+
+		for (uint32_t asteroid = 0; asteroid < asteroidBoxes.size(); ++asteroid)
+		{
+			expected.clear();
+			for (uint32_t other = 0; other < otherBoxes.size(); ++other)
+			{
+				if (IsOverlapping(asteroidBoxes[asteroid], otherBoxes[other]))
+					expected.push_back(other);
+			}
+
+			grid->GetCandidates(asteroid, fromGrid);
+			sweepAndPrune->GetCandidates(asteroid, fromSweepAndPrune);
+			CHECK(IsStrictlyIncreasing(fromGrid));
+			CHECK(IsStrictlyIncreasing(fromSweepAndPrune));
+			CHECK(fromSweepAndPrune == expected);
+			CHECK(std::includes(fromGrid.begin(), fromGrid.end(), expected.begin(), expected.end()));
+		}
+
+		for (TestObject& asteroid : asteroids)
+			MoveObject(asteroid);
+		for (TestObject& other : others)
+			MoveObject(other);
+	}
+
+	// Boxes touching the asteroid on an edge or a corner are candidates, the one just apart is not
+	AABB const asteroid{ { 0.0f, 0.0f }, { 32.0f, 32.0f } };
+	AABB const touching[] = { { { 32.0f, 8.0f }, { 48.0f, 24.0f } }, { { -16.0f, 32.0f }, { 0.0f, 48.0f } },
+							  { { 32.0f, 32.0f }, { 40.0f, 40.0f } }, { { 8.0f, -16.0f }, { 24.0f, 0.0f } },
+							  { { 32.5f, 0.0f }, { 40.0f, 8.0f } } };
+	for (CollisionBroadphase* broadphase : { grid.get(), sweepAndPrune.get() })
+	{
+		broadphase->Clear();
+		broadphase->Add(0, 0, asteroid, true);
+		for (uint32_t i = 0; i < 5; ++i)
+			broadphase->Add(TEST_ASTEROIDS + i, i, touching[i], false);
+		broadphase->FindPairs();
+	}
+	expected = { 0, 1, 2, 3 };
+	grid->GetCandidates(0, fromGrid);
+	sweepAndPrune->GetCandidates(0, fromSweepAndPrune);
+	CHECK(fromSweepAndPrune == expected);
+	CHECK(std::includes(fromGrid.begin(), fromGrid.end(), expected.begin(), expected.end()));
+
+	return checkFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
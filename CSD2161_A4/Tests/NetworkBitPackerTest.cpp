@@ -0,0 +1,85 @@
+/******************************************************************************/
+/*!
+\file		NetworkBitPackerTest.cpp
+\author
+\par
+\date
+\brief		This file round trips random transforms through the bit packer
+			and checks each field comes back within half a quantisation
+			step, exactly as QuantizeTransform predicts.
+
+Copyright (C) 20xx DigiPen Institute of Technology.
+Reproduction or disclosure of this file or its contents without the
+prior written consent of DigiPen Institute of Technology is prohibited.
+ */
+ /******************************************************************************/
+
+#include "Check.h"					// CHECK, checkFailures
+
+#include "NetworkBitPacker.h"		// BitWriter, BitReader, WriteTransform, ReadTransform
+
+#include <cmath>					// fabsf
+#include <cstdlib>					// EXIT_SUCCESS, EXIT_FAILURE
+#include <cstring>					// memcmp
+#include <random>					// std::mt19937
+
+int main()
+{
+	char buffer[64];
+	float const tolerance = 0.001f;	// float rounding at the edges of the playfield
+	float const positionErrorX = (POSITION_MAX_X - POSITION_MIN_X) / ((1 << POSITION_BITS) - 1) * 0.5f;
+	float const positionErrorY = (POSITION_MAX_Y - POSITION_MIN_Y) / ((1 << POSITION_BITS) - 1) * 0.5f;
+	float const velocityError = (2.0f * VELOCITY_MAX) / ((1 << VELOCITY_BITS) - 1) * 0.5f;
+	float const rotationError = PI / (1 << ROTATION_BITS);
+	float const scaleError = SCALE_MAX / ((1 << SCALE_BITS) - 1) * 0.5f;
+
+	std::mt19937 random(2161);
+	std::uniform_real_distribution<float> centred(-0.5f, 0.5f);
+	std::uniform_real_distribution<float> scale(10.0f, 60.0f);
+
+	for (int x = 0; x < 10000; ++x)
+	{
+		NetworkTransform sent({ centred(random) * SCREEN_SIZE_X, centred(random) * SCREEN_SIZE_Y },
+							  { centred(random) * 800.0f, centred(random) * 800.0f },
+							  centred(random) * TWO_PI,
+							  { scale(random), scale(random) });
+
+		BitWriter writer(buffer, sizeof(buffer));
+		WriteTransform(writer, sent, ObjectType::OBJ_ASTEROID);
+		BitReader reader(buffer, writer.GetBytesWritten());
+		NetworkTransform received = ReadTransform(reader, ObjectType::OBJ_ASTEROID);
+
+		// Angles may wrap from PI to -PI
+		float rotationDiff = fabsf(received.rotation - sent.rotation);
+		rotationDiff = (rotationDiff > PI) ? TWO_PI - rotationDiff : rotationDiff;
+
+		CHECK(!writer.HasOverflowed() && !reader.HasOverflowed());
+		CHECK(fabsf(received.position.x - sent.position.x) <= positionErrorX + tolerance);
+		CHECK(fabsf(received.position.y - sent.position.y) <= positionErrorY + tolerance);
+		CHECK(fabsf(received.velocity.x - sent.velocity.x) <= velocityError + tolerance);
+		CHECK(fabsf(received.velocity.y - sent.velocity.y) <= velocityError + tolerance);
+		CHECK(rotationDiff <= rotationError + tolerance);
+		CHECK(fabsf(received.scale.x - sent.scale.x) <= scaleError + tolerance);
+		CHECK(fabsf(received.scale.y - sent.scale.y) <= scaleError + tolerance);
+
+		// The receiver decodes exactly what QuantizeTransform predicts
+		NetworkTransform expected = QuantizeTransform(sent, ObjectType::OBJ_ASTEROID);
+		CHECK(memcmp(&expected, &received, sizeof(NetworkTransform)) == 0);
+	}
+
+	// Ships and bullets do not send their scale, 9 bytes instead of 36
+	BitWriter writer(buffer, sizeof(buffer));
+	WriteTransform(writer, NetworkTransform({ 10, 10 }, { 0, 0 }, 0, { SHIP_SCALE_X, SHIP_SCALE_Y }), ObjectType::OBJ_SHIP);
+	CHECK(writer.GetBytesWritten() == 9);
+
+	BitReader reader(buffer, writer.GetBytesWritten());
+	NetworkTransform ship = ReadTransform(reader, ObjectType::OBJ_SHIP);
+	CHECK(!reader.HasOverflowed() && ship.scale.x == SHIP_SCALE_X && ship.scale.y == SHIP_SCALE_Y);
+
+	// Writing past the end of the buffer is reported instead of overrunning it
+	BitWriter small(buffer, 4);
+	WriteTransform(small, NetworkTransform({ 10, 10 }, { 0, 0 }, 0, { 20, 20 }), ObjectType::OBJ_ASTEROID);
+	CHECK(small.HasOverflowed());
+
+	return checkFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}